@@ -0,0 +1,322 @@
+// Microbenchmarks de los costos fijos de las variantes de CE1: crear/unir hilos,
+// fork+exit según el RSS del padre, fallos de página en memoria compartida y
+// latencia de traspaso (spin, futex, mutex+cond, barrera) entre pares de CPUs.
+// Salida CSV en stdout (progreso en stderr); cada fila resume `reps` muestras.
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "phase_timer.h"
+#include "topology.h"
+
+#define CSV_HEADER "bench,param,cpu_a,cpu_b,reps,min_us,median_us,mean_us,p90_us"
+#define HANDOFF_ITERS 2000       // Idas y vueltas por muestra de traspaso
+#define FAULT_PAGES 4096         // Páginas por muestra de fallos de página
+#define SPIN_YIELD 1024          // Vueltas de espera activa antes de ceder la CPU
+
+// ===================== Estadísticas =====================
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Una fila: mínimo, mediana, media y percentil 90 de las muestras (en µs)
+static void print_row(const char *bench, long param, int cpu_a, int cpu_b, double *samples, int reps) {
+    double sum = 0.0;
+    qsort(samples, reps, sizeof(double), cmp_double);
+    for (int r = 0; r < reps; r++) sum += samples[r];
+    printf("%s,%ld,%d,%d,%d,%.3f,%.3f,%.3f,%.3f\n", bench, param, cpu_a, cpu_b, reps,
+           samples[0], samples[reps / 2], sum / reps, samples[(reps * 9) / 10 < reps ? (reps * 9) / 10 : reps - 1]);
+    fflush(stdout);
+}
+
+// ===================== Crear y unir hilos =====================
+static void* empty_thread(void *arg) {
+    return arg;
+}
+
+// Tiempo de crear `count` hilos vacíos y esperar a todos
+static void bench_thread_create(int count, int reps, double *samples) {
+    pthread_t *threads = (pthread_t*)malloc(count * sizeof(pthread_t));
+    if (threads == NULL) {
+        fprintf(stderr, "Fallo al reservar memoria (hilos)\n");
+        exit(1);
+    }
+    for (int r = 0; r < reps; r++) {
+        double start = pt_now();
+        for (int t = 0; t < count; t++) {
+            if (pthread_create(&threads[t], NULL, empty_thread, NULL) != 0) {
+                fprintf(stderr, "Fallo en pthread_create\n");
+                exit(1);
+            }
+        }
+        for (int t = 0; t < count; t++) pthread_join(threads[t], NULL);
+        samples[r] = (pt_now() - start) * 1e6;
+    }
+    free(threads);
+}
+
+// ===================== fork + exit según RSS =====================
+// El padre toca rss_mb MiB privados: fork copia sus tablas de páginas
+static void bench_fork(long rss_mb, int reps, double *samples) {
+    size_t bytes = (size_t)rss_mb << 20;
+    char *rss = NULL;
+    if (bytes > 0) {
+        rss = (char*)malloc(bytes);
+        if (rss == NULL) {
+            fprintf(stderr, "Fallo al reservar %ld MiB\n", rss_mb);
+            exit(1);
+        }
+        memset(rss, 1, bytes);
+    }
+    fflush(NULL);
+    for (int r = 0; r < reps; r++) {
+        double start = pt_now();
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            exit(1);
+        }
+        if (pid == 0) _exit(0);
+        waitpid(pid, NULL, 0);
+        samples[r] = (pt_now() - start) * 1e6;
+    }
+    free(rss);
+}
+
+// ===================== Fallos de página =====================
+enum { FAULT_PRIVATE, FAULT_SHARED, FAULT_SHARED_CHILD };
+
+// Costo por página (µs) de la primera escritura en memoria privada o compartida, o de
+// la primera lectura en un hijo de páginas compartidas que el padre ya escribió (lo que
+// hace cada trabajador de un pool de procesos con A y B)
+static void bench_fault(int kind, int pages, int reps, double *samples) {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t bytes = (size_t)pages * page;
+    double *child_time = (double*)mmap(NULL, sizeof(double), PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (child_time == MAP_FAILED) {
+        perror("mmap");
+        exit(1);
+    }
+    for (int r = 0; r < reps; r++) {
+        int flags = (kind == FAULT_PRIVATE) ? MAP_PRIVATE : MAP_SHARED;
+        char *region = (char*)mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            perror("mmap");
+            exit(1);
+        }
+        if (kind == FAULT_SHARED_CHILD) {
+            memset(region, 1, bytes);
+            fflush(NULL);
+            pid_t pid = fork();
+            if (pid < 0) {
+                perror("fork");
+                exit(1);
+            }
+            if (pid == 0) {
+                long sum = 0;
+                double start = pt_now();
+                for (size_t off = 0; off < bytes; off += page) sum += *(volatile char*)(region + off);
+                *child_time = pt_now() - start;
+                _exit(sum == 0);
+            }
+            waitpid(pid, NULL, 0);
+            samples[r] = *child_time * 1e6 / pages;
+        } else {
+            double start = pt_now();
+            for (size_t off = 0; off < bytes; off += page) region[off] = 1;
+            samples[r] = (pt_now() - start) * 1e6 / pages;
+        }
+        munmap(region, bytes);
+    }
+    munmap(child_time, sizeof(double));
+}
+
+// ===================== Traspaso entre dos CPUs =====================
+// Ping-pong: A publica seq = 2i+1 y espera 2i+2; B espera 2i+1 y publica 2i+2.
+// Cada muestra es la latencia de un traspaso (ida y vuelta / 2). La barrera mide un cruce.
+enum { HO_SPIN, HO_FUTEX, HO_MUTEX, HO_BARRIER, HO_COUNT };
+static const char *handoff_names[HO_COUNT] = { "handoff_spin", "handoff_futex", "handoff_mutex", "handoff_barrier" };
+
+typedef struct {
+    int kind;
+    int cpus[2];
+    int reps;
+    double *samples;
+    int seq;                     // Atómico (spin y futex) o protegido por lock (mutex)
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_barrier_t barrier;
+} handoff_t;
+
+typedef struct {
+    handoff_t *h;
+    int side;
+} handoff_arg_t;
+
+static void futex_wait(int *addr, int val) {
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static void futex_wake(int *addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static void handoff_post(handoff_t *h, int val) {
+    if (h->kind == HO_MUTEX) {
+        pthread_mutex_lock(&h->lock);
+        h->seq = val;
+        pthread_cond_signal(&h->cond);
+        pthread_mutex_unlock(&h->lock);
+        return;
+    }
+    __atomic_store_n(&h->seq, val, __ATOMIC_RELEASE);
+    if (h->kind == HO_FUTEX) futex_wake(&h->seq);
+}
+
+static void handoff_wait(handoff_t *h, int val) {
+    if (h->kind == HO_MUTEX) {
+        pthread_mutex_lock(&h->lock);
+        while (h->seq != val) pthread_cond_wait(&h->cond, &h->lock);
+        pthread_mutex_unlock(&h->lock);
+        return;
+    }
+    int cur, spins = 0;
+    while ((cur = __atomic_load_n(&h->seq, __ATOMIC_ACQUIRE)) != val) {
+        if (h->kind == HO_FUTEX) futex_wait(&h->seq, cur);
+        else if (++spins % SPIN_YIELD == 0) sched_yield(); // Misma CPU: sin esto no avanza
+    }
+}
+
+static void* handoff_thread(void *arg) {
+    handoff_arg_t *a = (handoff_arg_t*)arg;
+    handoff_t *h = a->h;
+    topo_pin_self(&h->cpus[a->side], 1);
+    pthread_barrier_wait(&h->barrier);
+    for (int r = 0; r < h->reps; r++) {
+        double start = pt_now();
+        for (int i = 0; i < HANDOFF_ITERS; i++) {
+            if (h->kind == HO_BARRIER) {
+                pthread_barrier_wait(&h->barrier);
+            } else if (a->side == 0) {
+                handoff_post(h, 2 * i + 1);
+                handoff_wait(h, 2 * i + 2);
+            } else {
+                handoff_wait(h, 2 * i + 1);
+                handoff_post(h, 2 * i + 2);
+            }
+        }
+        double elapsed = pt_now() - start;
+        if (a->side == 0) h->samples[r] = elapsed * 1e6 / HANDOFF_ITERS / (h->kind == HO_BARRIER ? 1 : 2);
+        // Ambos lados empiezan la siguiente muestra desde el mismo punto
+        pthread_barrier_wait(&h->barrier);
+        if (h->kind != HO_BARRIER && a->side == 0) h->seq = 0;
+        pthread_barrier_wait(&h->barrier);
+    }
+    return NULL;
+}
+
+static void bench_handoff(int kind, int cpu_a, int cpu_b, int reps, double *samples) {
+    handoff_t h;
+    memset(&h, 0, sizeof(h));
+    h.kind = kind;
+    h.cpus[0] = cpu_a;
+    h.cpus[1] = cpu_b;
+    h.reps = reps;
+    h.samples = samples;
+    pthread_mutex_init(&h.lock, NULL);
+    pthread_cond_init(&h.cond, NULL);
+    pthread_barrier_init(&h.barrier, NULL, 2);
+    pthread_t threads[2];
+    handoff_arg_t args[2] = { { &h, 0 }, { &h, 1 } };
+    for (int s = 0; s < 2; s++) {
+        if (pthread_create(&threads[s], NULL, handoff_thread, &args[s]) != 0) {
+            fprintf(stderr, "Fallo en pthread_create\n");
+            exit(1);
+        }
+    }
+    for (int s = 0; s < 2; s++) pthread_join(threads[s], NULL);
+    pthread_barrier_destroy(&h.barrier);
+    pthread_cond_destroy(&h.cond);
+    pthread_mutex_destroy(&h.lock);
+}
+
+// ===================== Programa Principal =====================
+static void usage(const char *p) {
+    printf("Uso: %s [repeticiones] [rss_max_MiB] [--all-pairs]\n", p);
+    printf("  repeticiones: muestras por fila (por defecto 20)\n");
+    printf("  rss_max_MiB: RSS máximo del padre en fork+exit (por defecto 256)\n");
+    printf("  --all-pairs: traspaso entre todos los pares de CPUs (por defecto: CPU 0 con cada una)\n");
+    printf("Salida: " CSV_HEADER "\n");
+}
+
+int main(int argc, char *argv[]) {
+    int reps = 20, all_pairs = 0, npos = 0;
+    long max_rss = 256;
+    char *pos[2];
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--all-pairs") == 0) all_pairs = 1;
+        else if (argv[a][0] != '-' && npos < 2) pos[npos++] = argv[a];
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (npos >= 1) reps = atoi(pos[0]);
+    if (npos >= 2) max_rss = atol(pos[1]);
+    if (reps <= 0 || max_rss < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    double *samples = (double*)malloc(reps * sizeof(double));
+    int *cpus = (int*)malloc(TOPO_MAX_CPUS * sizeof(int));
+    if (samples == NULL || cpus == NULL) {
+        fprintf(stderr, "Fallo al reservar memoria\n");
+        return 1;
+    }
+    int num_cpus = topo_online_cpus(cpus, TOPO_MAX_CPUS);
+
+    printf(CSV_HEADER "\n");
+
+    fprintf(stderr, "Crear y unir hilos...\n");
+    for (int count = 1; count <= 64; count *= 2) {
+        bench_thread_create(count, reps, samples);
+        print_row("thread_create_join", count, -1, -1, samples, reps);
+    }
+
+    fprintf(stderr, "fork + exit...\n");
+    for (long rss = 0; rss <= max_rss; rss = (rss == 0) ? 1 : rss * 4) {
+        bench_fork(rss, reps, samples);
+        print_row("fork_exit_rss_mb", rss, -1, -1, samples, reps);
+    }
+
+    fprintf(stderr, "Fallos de página...\n");
+    const char *fault_names[3] = { "fault_private_write", "fault_shared_write", "fault_shared_child_read" };
+    for (int kind = FAULT_PRIVATE; kind <= FAULT_SHARED_CHILD; kind++) {
+        bench_fault(kind, FAULT_PAGES, reps, samples);
+        print_row(fault_names[kind], FAULT_PAGES, -1, -1, samples, reps);
+    }
+
+    // Pares (a, b): CPU 0 con cada CPU (incluida ella misma) o todos los a <= b
+    fprintf(stderr, "Traspasos entre %d CPUs...\n", num_cpus);
+    for (int i = 0; i < (all_pairs ? num_cpus : 1); i++) {
+        for (int j = i; j < num_cpus; j++) {
+            for (int kind = 0; kind < HO_COUNT; kind++) {
+                bench_handoff(kind, cpus[i], cpus[j], reps, samples);
+                print_row(handoff_names[kind], HANDOFF_ITERS, cpus[i], cpus[j], samples, reps);
+            }
+        }
+    }
+
+    free(cpus);
+    free(samples);
+    return 0;
+}
@@ -1,23 +1,30 @@
-// Ejecuta versión secuencial, pthreads y procesos (fork)
+// Ejecuta versión secuencial, pthreads, procesos (pool pre-creado con fork) e híbrido por nodo NUMA
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <signal.h>
 #include <pthread.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sys/mman.h>
 #include <sys/wait.h>
+#include "reference_cache.h"
+#include "thread_pool.h"
+#include "tile_scheduler.h"
+#include "process_pool.h"
+#include "topology.h"
+#include "phase_timer.h"
 
 // ===================== Utilidades de tiempo =====================
 static double get_user_time() {
     struct rusage usage; getrusage(RUSAGE_SELF, &usage);
     return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
 }
-static double get_wall_time() {
-    struct timeval tv; gettimeofday(&tv, NULL);
-    return tv.tv_sec + tv.tv_usec / 1000000.0;
-}
+// Pared monotónica, igual que el resto de CE1 (gettimeofday salta con ajustes del reloj)
+static double get_wall_time() { return pt_now(); }
 
 // ===================== Gestión de matrices (int ** estilo) =====================
 static int **allocate_matrix(int n) {
@@ -28,6 +35,8 @@ static int **allocate_matrix(int n) {
 }
 static void free_matrix(int **m,int n){ if(!m) return; for(int i=0;i<n;i++) free(m[i]); free(m);} 
 static void initialize_matrix(int **m,int n,int seed){ srand(seed); for(int i=0;i<n;i++) for(int j=0;j<n;j++) m[i][j]=rand()%100; }
+// Escribe todas las filas una vez para que los fallos de página no caigan dentro de una medición
+static void prefault_matrix(int **m,int n){ for(int i=0;i<n;i++) memset(m[i],0,n*sizeof(int)); }
 
 // ===================== Secuencial =====================
 static void matmul_seq(int **A,int **B,int **C,int n){
@@ -39,112 +48,417 @@ static void matmul_seq(int **A,int **B,int **C,int n){
     }
 }
 
-// ===================== Pthreads =====================
-typedef struct { int **A, **B, **C; int n; int start_row; int end_row; } thread_data_t;
-static void* thread_worker(void *arg){
+// ===================== Afinidad (hilos y procesos hijos) =====================
+// El trabajador w (hilo del pool o hijo del pool de procesos) se fija a order[w % count]
+typedef struct { int policy; int count; int order[TOPO_MAX_CPUS]; } affinity_t;
+static __thread int pinned_cpu = -1; // CPU fijada en este hilo o hijo; evita repetir la llamada
+static void pin_cpu(int cpu){ if(cpu!=pinned_cpu){ topo_pin_self(&cpu,1); pinned_cpu=cpu; } }
+static void pin_worker(void *arg,int w){ affinity_t *af=(affinity_t*)arg; if(af->count>0) pin_cpu(af->order[w % af->count]); }
+
+// ===================== Pthreads (pool persistente + teselas dinámicas) =====================
+// Cada tarea del pool es un trabajador que pide teselas de C al planificador hasta agotarlas.
+// En el barrido el pool tiene más hilos que tareas y la tarea w cae en cualquier hilo
+// (reparto por colas y robo): se fija a order[w] al empezar para que la CPU sea la de la política.
+typedef struct { int **A, **B, **C; int n; ts_sched_t *sched; affinity_t *aff; } thread_data_t;
+static void thread_task(void *arg,int begin,int end){
     thread_data_t *d=(thread_data_t*)arg;
-    for(int i=d->start_row;i<d->end_row;i++){
-        for(int j=0;j<d->n;j++){
-            int sum=0; for(int k=0;k<d->n;k++) sum += d->A[i][k]*d->B[k][j];
-            d->C[i][j]=sum;
+    for(int w=begin;w<end;w++){
+        int first,count;
+        pin_worker(d->aff,w);
+        while(ts_next(d->sched,w,&first,&count)){
+            for(int t=first;t<first+count;t++){
+                int i0,i1,j0,j1; ts_tile_bounds(d->sched,t,&i0,&i1,&j0,&j1);
+                for(int i=i0;i<i1;i++) for(int j=j0;j<j1;j++){
+                    int sum=0; for(int k=0;k<d->n;k++) sum += d->A[i][k]*d->B[k][j];
+                    d->C[i][j]=sum;
+                }
+            }
         }
     }
-    return NULL;
 }
-static void matmul_pthreads(int **A,int **B,int **C,int n,int num_threads){
-    pthread_t *threads = (pthread_t*)malloc(num_threads*sizeof(pthread_t));
-    thread_data_t *td = (thread_data_t*)malloc(num_threads*sizeof(thread_data_t));
-    int base = n / num_threads; int rem = n % num_threads; int row=0;
-    for(int t=0;t<num_threads;t++){
-        int extra = (t<rem)?1:0; int start=row; int end = start + base + extra; row=end;
-        td[t].A=A; td[t].B=B; td[t].C=C; td[t].n=n; td[t].start_row=start; td[t].end_row=end;
-        pthread_create(&threads[t], NULL, thread_worker, &td[t]);
+// El pool puede tener más hilos que num_threads (barrido): solo se publican num_threads tareas
+static void matmul_pthreads(tp_pool_t *pool,int **A,int **B,int **C,int n,int num_threads,ts_sched_t *sched,affinity_t *aff){
+    ts_init(sched,n,n,0,0,num_threads);
+    thread_data_t td = {A,B,C,n,sched,aff};
+    if(!pool || !tp_parallel_for(pool,0,num_threads,1,thread_task,&td)){ fprintf(stderr,"Fallo en el pool de hilos\n"); exit(1); }
+}
+
+// ===================== Procesos (pool pre-creado + teselas dinámicas) =====================
+// Los datos y el planificador viven en la arena compartida del pool: los hijos ya existen
+// cuando se llenan, así que no pueden estar en la pila ni en el heap del padre.
+// aff sí está en el heap: se llenó antes del fork y cada hijo tiene su copia. Como con
+// los hilos, el trabajo p lo toma cualquier hijo del anillo y se fija a order[p].
+typedef struct { int *A, *B, *C; int n; ts_sched_t *sched; affinity_t *aff; } proc_data_t;
+static void proc_task(void *arg,int begin,int end){
+    proc_data_t *d=(proc_data_t*)arg; int n=d->n;
+    for(int p=begin;p<end;p++){
+        int first,count;
+        pin_worker(d->aff,p);
+        while(ts_next(d->sched,p,&first,&count)){
+            for(int t=first;t<first+count;t++){
+                int i0,i1,j0,j1; ts_tile_bounds(d->sched,t,&i0,&i1,&j0,&j1);
+                for(int i=i0;i<i1;i++){
+                    int row_off = i*n;
+                    for(int j=j0;j<j1;j++){
+                        int sum=0; for(int k=0;k<n;k++) sum += d->A[row_off + k]*d->B[k*n + j];
+                        d->C[row_off + j]=sum;
+                    }
+                }
+            }
+        }
     }
-    for(int t=0;t<num_threads;t++) pthread_join(threads[t], NULL);
-    free(threads); free(td);
+}
+static void matmul_process(pp_pool_t *pool,proc_data_t *pd,int num_procs){
+    ts_init(pd->sched,pd->n,pd->n,0,0,num_procs);
+    if(!pp_parallel_for(pool,0,num_procs,1,proc_task,pd)){ fprintf(stderr,"Un proceso del pool terminó inesperadamente\n"); exit(1); }
 }
 
-// ===================== Procesos (fork + mmap) =====================
-static void child_proc(int *A,int *B,int *C,int n,int start,int end){
-    for(int i=start;i<end;i++){
-        int row_off = i*n;
-        for(int j=0;j<n;j++){
-            int sum=0; for(int k=0;k<n;k++) sum += A[row_off + k]*B[k*n + j];
-            C[row_off + j]=sum;
+// ===================== Híbrido (un proceso por nodo NUMA + hilos fijados) =====================
+// Cada proceso se fija a las CPUs de su nodo, copia A y B a memoria privada (la primera
+// escritura la ubica en el nodo local) y calcula con un equipo de hilos fijados a CPUs del nodo.
+// Todos los hilos de todos los nodos sacan teselas del mismo planificador compartido.
+// Padre y nodos se coordinan con dos barreras compartidas: `start` publica la operación y
+// `finish` marca que todos terminaron. Los equipos y las réplicas se dimensionan para el caso
+// más grande (max_n, trabajadores al arrancar); cada multiplicación usa n y num_threads actuales.
+// num_threads y first_thread se pueden cambiar entre multiplicaciones (hybrid_split).
+enum { HY_LOAD = 1, HY_MULTIPLY = 2, HY_QUIT = 3 };
+typedef struct {
+    pthread_barrier_t start, finish;     // Compartidas entre procesos: nodos + padre
+    int op; int failed;
+    int n, max_n; int *A, *B, *C;        // A y B originales y C resultado, en la arena
+    ts_sched_t *sched;
+    int num_nodes, total_threads;
+    int first_thread[TOPO_MAX_NODES];    // Índice global del primer hilo de cada nodo
+    int num_threads[TOPO_MAX_NODES];     // Hilos activos de cada nodo en la próxima multiplicación
+    int team_threads[TOPO_MAX_NODES];    // Hilos creados en cada nodo
+    pid_t pids[TOPO_MAX_NODES];
+} hybrid_ctl_t;
+typedef struct { hybrid_ctl_t *ctl; const topo_node_t *node; int idx; int *A, *B; } hybrid_node_t;
+// También al empezar cada tarea: el equipo puede tener más hilos que tareas (barrido)
+static void hy_pin_thread(void *arg,int w){ hybrid_node_t *h=(hybrid_node_t*)arg; pin_cpu(h->node->cpus[w % h->node->num_cpus]); }
+static void hy_task(void *arg,int begin,int end){
+    hybrid_node_t *h=(hybrid_node_t*)arg; hybrid_ctl_t *ctl=h->ctl; int n=ctl->n;
+    for(int w=begin;w<end;w++){
+        int first,count,gid=ctl->first_thread[h->idx]+w;
+        hy_pin_thread(h,w);
+        while(ts_next(ctl->sched,gid,&first,&count)){
+            for(int t=first;t<first+count;t++){
+                int i0,i1,j0,j1; ts_tile_bounds(ctl->sched,t,&i0,&i1,&j0,&j1);
+                for(int i=i0;i<i1;i++){
+                    int row_off = i*n;
+                    for(int j=j0;j<j1;j++){
+                        int sum=0; for(int k=0;k<n;k++) sum += h->A[row_off + k]*h->B[k*n + j];
+                        ctl->C[row_off + j]=sum;
+                    }
+                }
+            }
         }
     }
-    _exit(0);
 }
-static void matmul_process(int *A,int *B,int *C,int n,int num_procs){
-    int base = n / num_procs; int rem = n % num_procs; int row=0;
-    for(int p=0;p<num_procs;p++){
-        int extra=(p<rem)?1:0; int start=row; int end=start+base+extra; row=end;
+static void hy_node_main(hybrid_ctl_t *ctl,const topo_node_t *node,int idx){
+    size_t max_bytes=(size_t)ctl->max_n*ctl->max_n*sizeof(int);
+    hybrid_node_t h={ctl,node,idx,NULL,NULL};
+    topo_pin_self(node->cpus,node->num_cpus);
+    h.A=mmap(NULL,max_bytes,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    h.B=mmap(NULL,max_bytes,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    tp_pool_t *team = (h.A!=MAP_FAILED && h.B!=MAP_FAILED) ? tp_create_ex(ctl->team_threads[idx],hy_pin_thread,&h) : NULL;
+    // Si algo falló el nodo sigue entrando a las barreras para no bloquear al resto
+    if(!team) __atomic_store_n(&ctl->failed,1,__ATOMIC_RELEASE);
+    pthread_barrier_wait(&ctl->finish); // Listo
+    for(;;){
+        pthread_barrier_wait(&ctl->start);
+        if(ctl->op==HY_QUIT) break;
+        size_t bytes=(size_t)ctl->n*ctl->n*sizeof(int);
+        if(team && ctl->op==HY_LOAD){ memcpy(h.A,ctl->A,bytes); memcpy(h.B,ctl->B,bytes); }
+        else if(team && ctl->op==HY_MULTIPLY) tp_parallel_for(team,0,ctl->num_threads[idx],1,hy_task,&h);
+        pthread_barrier_wait(&ctl->finish);
+    }
+    tp_destroy(team); _exit(0);
+}
+static void hybrid_run(hybrid_ctl_t *ctl,int op){ ctl->op=op; pthread_barrier_wait(&ctl->start); if(op!=HY_QUIT) pthread_barrier_wait(&ctl->finish); }
+// Reparte `workers` hilos entre los nodos arrancados (como mucho un nodo por hilo; el resto queda con 0)
+static void hybrid_split(hybrid_ctl_t *ctl,int workers){
+    int used = (ctl->num_nodes < workers) ? ctl->num_nodes : workers; ctl->total_threads = workers;
+    for(int d=0,next=0;d<ctl->num_nodes;d++){ ctl->first_thread[d]=next; ctl->num_threads[d] = (d<used) ? workers/used + (d<workers%used) : 0; next+=ctl->num_threads[d]; }
+}
+static void hybrid_stop(hybrid_ctl_t *ctl){
+    hybrid_run(ctl,HY_QUIT);
+    for(int d=0;d<ctl->num_nodes;d++) waitpid(ctl->pids[d],NULL,0);
+    pthread_barrier_destroy(&ctl->start); pthread_barrier_destroy(&ctl->finish);
+}
+// Crea un proceso por nodo con equipos para `workers` hilos y réplicas de max_n x max_n.
+// Si falla no deja nodos vivos: los ya creados se detienen antes de devolver 0.
+static int hybrid_start(hybrid_ctl_t *ctl,const topo_node_t *nodes,int num_nodes,int workers,int max_n,int *A,int *B,int *C,ts_sched_t *sched){
+    ctl->num_nodes = (num_nodes < workers) ? num_nodes : workers;
+    ctl->n=max_n; ctl->max_n=max_n; ctl->A=A; ctl->B=B; ctl->C=C; ctl->sched=sched; ctl->failed=0;
+    hybrid_split(ctl,workers);
+    for(int d=0;d<ctl->num_nodes;d++) ctl->team_threads[d]=ctl->num_threads[d];
+    pthread_barrierattr_t attr; pthread_barrierattr_init(&attr); pthread_barrierattr_setpshared(&attr,PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&ctl->start,&attr,ctl->num_nodes+1); pthread_barrier_init(&ctl->finish,&attr,ctl->num_nodes+1);
+    pthread_barrierattr_destroy(&attr);
+    fflush(NULL);
+    for(int d=0;d<ctl->num_nodes;d++){
+        // ctl está en la arena compartida: el hijo no debe escribir su 0 en pids[d]
         pid_t pid=fork();
-        if(pid<0){ perror("fork"); exit(1);} else if(pid==0){ child_proc(A,B,C,n,start,end); }
+        if(pid<0){
+            // Los nodos ya creados esperan en la barrera `finish`, que nunca se completará
+            perror("fork");
+            for(int e=0;e<d;e++){ kill(ctl->pids[e],SIGKILL); waitpid(ctl->pids[e],NULL,0); }
+            pthread_barrier_destroy(&ctl->start); pthread_barrier_destroy(&ctl->finish);
+            ctl->num_nodes=0; return 0;
+        } else if(pid==0) hy_node_main(ctl,&nodes[d],d);
+        ctl->pids[d]=pid;
     }
-    while(wait(NULL)>0){} // esperar todos
+    pthread_barrier_wait(&ctl->finish);
+    if(__atomic_load_n(&ctl->failed,__ATOMIC_ACQUIRE)){ hybrid_stop(ctl); return 0; }
+    return 1;
+}
+// Réplicas locales de las primeras n x n de A y B, fuera de la medición
+static void hybrid_load(hybrid_ctl_t *ctl,int n){ ctl->n=n; hybrid_run(ctl,HY_LOAD); }
+static void matmul_hybrid(hybrid_ctl_t *ctl){ ts_init(ctl->sched,ctl->n,ctl->n,0,0,ctl->total_threads); hybrid_run(ctl,HY_MULTIPLY); }
+
+// ===================== Salida =====================
+// Los hijos del pool esperan en sem_wait y los nodos del híbrido en una barrera: si el padre
+// termina sin detenerlos quedan huérfanos bloqueados. Toda salida posterior a pp_create_ex
+// pasa por stop_workers: el final normal la llama y está registrada con atexit para los
+// `return 1` de main y los exit(1) de las funciones de medición. Es idempotente.
+static pp_pool_t *live_pool;
+static hybrid_ctl_t *live_hybrid;   // Vive en la arena de live_pool: se detiene antes
+static void stop_workers(void){
+    tp_global_destroy();
+    if(live_hybrid){ hybrid_stop(live_hybrid); live_hybrid=NULL; }
+    if(live_pool){ pp_destroy(live_pool); live_pool=NULL; }
 }
 
 // ===================== Verificación =====================
-static int verify_all(int **C_seq,int **C_thr,int *C_proc,int n){
-    for(int i=0;i<n;i++) for(int j=0;j<n;j++){
-        int vseq=C_seq[i][j]; int vthr=C_thr[i][j]; int vproc=C_proc[i*n + j];
-        if(vseq!=vthr || vseq!=vproc){
-            fprintf(stderr,"Diferencia en (%d,%d): seq=%d thr=%d proc=%d\n", i,j,vseq,vthr,vproc);
+// Compara hilos, procesos e híbrido contra el hash por fila de la referencia secuencial
+static int verify_all(const ref_entry_t *ref,int **C_thr,int *C_proc,int *C_hyb,int n){
+    for(int i=0;i<n;i++){
+        int ok_thr = ref_check_row_int(ref,i,C_thr[i]); int ok_proc = ref_check_row_int(ref,i,&C_proc[i*n]); int ok_hyb = ref_check_row_int(ref,i,&C_hyb[i*n]);
+        if(!ok_thr || !ok_proc || !ok_hyb){
+            fprintf(stderr,"Diferencia en fila %d: hilos=%s procesos=%s híbrido=%s\n", i, ok_thr?"ok":"distinta", ok_proc?"ok":"distinta", ok_hyb?"ok":"distinta");
             return 0;
         }
     }
     return 1;
 }
+// Modo CSV: sin referencia secuencial, las tres versiones paralelas deben coincidir entre sí
+static int verify_parallel(int **C_thr,int *C_proc,int *C_hyb,int n){
+    for(int i=0;i<n;i++) if(memcmp(C_thr[i],&C_proc[i*n],n*sizeof(int))!=0 || memcmp(C_thr[i],&C_hyb[i*n],n*sizeof(int))!=0){ fprintf(stderr,"Diferencia en fila %d entre versiones paralelas\n", i); return 0; }
+    return 1;
+}
+
+// ===================== Modo CSV y barrido =====================
+#define CSV_HEADER "run,n,workers,thr_wall_s,proc_wall_s,hyb_wall_s,win,affinity"
+#define SWEEP_MAX 64
+// Carga las primeras n x n de A y B (int**, arena y réplicas del híbrido); las matrices están
+// dimensionadas para el caso más grande y se reutilizan en cada configuración
+static void load_inputs(int **A,int **B,proc_data_t *pd,hybrid_ctl_t *hy,int n,int seedA,int seedB){
+    initialize_matrix(A,n,seedA); initialize_matrix(B,n,seedB);
+    pd->n = n; for(int i=0;i<n;i++) for(int j=0;j<n;j++){ pd->A[i*n+j]=A[i][j]; pd->B[i*n+j]=B[i][j]; }
+    hybrid_load(hy,n);
+}
+// Una fila CSV: hilos, procesos e híbrido con `workers` trabajadores sobre las entradas cargadas
+static int csv_row(tp_pool_t *tp,pp_pool_t *pool,proc_data_t *pd,hybrid_ctl_t *hy,int **A,int **B,int **C_thr,int *C_hyb,int n,int workers,int run_id,int policy){
+    hybrid_split(hy,workers);
+    double s_wall = get_wall_time(); matmul_pthreads(tp,A,B,C_thr,n,workers,pd->sched,pd->aff); double thr_wall = get_wall_time() - s_wall;
+    s_wall = get_wall_time(); matmul_process(pool,pd,workers); double proc_wall = get_wall_time() - s_wall;
+    s_wall = get_wall_time(); matmul_hybrid(hy); double hyb_wall = get_wall_time() - s_wall;
+    int ok = verify_parallel(C_thr,pd->C,C_hyb,n);
+    double best = thr_wall < proc_wall ? thr_wall : proc_wall; if(hyb_wall < best) best = hyb_wall;
+    int ties = (thr_wall==best) + (proc_wall==best) + (hyb_wall==best);
+    const char *win = (ties > 1) ? "tie" : (thr_wall==best) ? "threads" : (proc_wall==best) ? "processes" : "hybrid";
+    if(ok){ printf("%d,%d,%d,%.6f,%.6f,%.6f,%s,%s\n", run_id, n, workers, thr_wall, proc_wall, hyb_wall, win, topo_policy_name(policy)); fflush(stdout); }
+    return ok;
+}
+// Lista "10,100,200" o rangos "1..16" (se pueden combinar: "1..4,8,16"); -1 si es inválida
+static int parse_list(const char *s,int *out,int max){
+    int count=0;
+    while(*s){
+        char *end; long lo=strtol(s,&end,10), hi=lo;
+        if(end==s || lo<=0) return -1;
+        if(strncmp(end,"..",2)==0){ s=end+2; hi=strtol(s,&end,10); if(end==s || hi<lo) return -1; }
+        for(long v=lo; v<=hi; v++){ if(count>=max) return -1; out[count++]=(int)v; }
+        if(*end==',') end++; else if(*end) return -1;
+        s=end;
+    }
+    return count;
+}
+// Valor de "--name=V" o "--name V"; NULL si argv[*a] no es esa opción
+static const char *opt_value(int argc,char *argv[],int *a,const char *name){
+    size_t len=strlen(name);
+    if(strncmp(argv[*a],name,len)!=0) return NULL;
+    if(argv[*a][len]=='=') return argv[*a]+len+1;
+    if(argv[*a][len]=='\0' && *a+1<argc) return argv[++*a];
+    return NULL;
+}
 
 // ===================== Programa Principal =====================
 static void usage(const char *p){
-    printf("Uso: %s <tamaño_matriz> [num_trabajadores] [semilla_A] [semilla_B]\n", p);
+    printf("Uso: %s <tamaño_matriz> [num_trabajadores] [semilla_A] [semilla_B] [--csv] [--run=N] [--affinity=P]\n", p);
+    printf("     %s --sizes=LISTA [--workers=LISTA] [--runs=R] [semilla_A] [semilla_B] [--run=N] [--affinity=P]\n", p);
+    printf("     %s --csv-header\n", p);
+    printf("  --csv: solo la fila " CSV_HEADER " (sin secuencial)\n");
+    printf("  --sizes: barrido en un solo proceso (cabecera + filas CSV); LISTA como 10,100,200 o 1..16\n");
+    printf("  --workers: trabajadores del barrido (por defecto: número de CPUs); --runs: repeticiones (1)\n");
+    printf("  --affinity: none (por defecto), compact, scatter o core (un hilo por núcleo físico)\n");
     printf("Ejemplo: %s 1024 8 123 456\n", p);
+    printf("         %s --sizes=100,200,400 --workers=1..8 --runs=5 123 456\n", p);
 }
 
 int main(int argc,char *argv[]){
-    if(argc<2 || argc>5){ usage(argv[0]); return 1; }
-    int n = atoi(argv[1]); if(n<=0){ fprintf(stderr,"Tamaño inválido\n"); return 1; }
-    int workers;
-    if(argc>=3){ workers=atoi(argv[2]); if(workers<=0) { fprintf(stderr,"Trabajadores inválidos\n"); return 1; } }
-    else { workers = (int)sysconf(_SC_NPROCESSORS_ONLN); if(workers<=0) workers=2; }
-    int seedA = (argc>=4)?atoi(argv[3]):(int)time(NULL);
-    int seedB = (argc==5)?atoi(argv[4]):seedA+1;
-
-    printf("=== Multiplicación de Matrices: Secuencial vs Hilos vs Procesos ===\n");
-    printf("Tamaño: %d x %d\n", n,n);
-    printf("Trabajadores (hilos/procesos): %d\n", workers);
-    printf("Semillas: A=%d B=%d\n", seedA, seedB);
+    int csv=0, run_id=0, npos=0, policy=TOPO_NONE, runs=1, num_sizes=0, num_wlist=0; char *pos[4];
+    int sizes[SWEEP_MAX], wlist[SWEEP_MAX]; const char *val;
+    for(int a=1;a<argc;a++){
+        if(strcmp(argv[a],"--csv-header")==0){ printf(CSV_HEADER "\n"); return 0; }
+        else if(strcmp(argv[a],"--csv")==0) csv=1;
+        else if(strncmp(argv[a],"--run=",6)==0) run_id=atoi(argv[a]+6);
+        else if(strncmp(argv[a],"--affinity=",11)==0){ policy=topo_policy_parse(argv[a]+11); if(policy<0){ usage(argv[0]); return 1; } }
+        else if((val=opt_value(argc,argv,&a,"--sizes"))){ num_sizes=parse_list(val,sizes,SWEEP_MAX); if(num_sizes<=0){ usage(argv[0]); return 1; } }
+        else if((val=opt_value(argc,argv,&a,"--workers"))){ num_wlist=parse_list(val,wlist,SWEEP_MAX); if(num_wlist<=0){ usage(argv[0]); return 1; } }
+        else if((val=opt_value(argc,argv,&a,"--runs"))){ runs=atoi(val); if(runs<=0){ usage(argv[0]); return 1; } }
+        else if(npos<4) pos[npos++]=argv[a];
+        else { usage(argv[0]); return 1; }
+    }
+    // Barrido: las posicionales son solo las semillas
+    int sweep = num_sizes>0;
+    if(sweep && npos>2){ usage(argv[0]); return 1; }
+    if(!sweep && (npos<1 || num_wlist>0 || runs!=1)){ usage(argv[0]); return 1; }
+    int n=0, workers=0; // En el barrido, los máximos: todo se dimensiona para el caso más grande
+    if(sweep){
+        csv=1; if(run_id<=0) run_id=1;
+        if(num_wlist==0){ wlist[0]=(int)sysconf(_SC_NPROCESSORS_ONLN); if(wlist[0]<=0) wlist[0]=2; num_wlist=1; }
+        for(int s=0;s<num_sizes;s++) if(sizes[s]>n) n=sizes[s];
+        for(int w=0;w<num_wlist;w++) if(wlist[w]>workers) workers=wlist[w];
+    } else {
+        n = atoi(pos[0]); if(n<=0){ fprintf(stderr,"Tamaño inválido\n"); return 1; }
+        if(npos>=2){ workers=atoi(pos[1]); if(workers<=0) { fprintf(stderr,"Trabajadores inválidos\n"); return 1; } }
+        else { workers = (int)sysconf(_SC_NPROCESSORS_ONLN); if(workers<=0) workers=2; }
+    }
+    int first_seed = sweep ? 0 : 2;
+    int seedA = (npos>first_seed)?atoi(pos[first_seed]):(int)time(NULL);
+    int seedB = (npos>first_seed+1)?atoi(pos[first_seed+1]):seedA+1;
 
-    // Matrices para seq/pthreads
-    int **A = allocate_matrix(n); int **B = allocate_matrix(n); int **C_seq = allocate_matrix(n); int **C_thr = allocate_matrix(n);
-    if(!A||!B||!C_seq||!C_thr){ fprintf(stderr,"Fallo al reservar memoria (int**)\n"); return 1; }
-    initialize_matrix(A,n,seedA); initialize_matrix(B,n,seedB);
+    if(!csv){
+        printf("=== Multiplicación de Matrices: Secuencial vs Hilos vs Procesos ===\n");
+        printf("Tamaño: %d x %d\n", n,n);
+        printf("Trabajadores (hilos/procesos): %d\n", workers);
+        printf("Semillas: A=%d B=%d\n", seedA, seedB);
+    }
+
+    // Orden de CPUs de la política; hilos y procesos usan el mismo
+    affinity_t *aff = (affinity_t*)calloc(1, sizeof(affinity_t)); topo_t *topo = (topo_t*)malloc(sizeof(topo_t));
+    if(!aff || !topo){ fprintf(stderr,"Fallo al reservar memoria (topología)\n"); return 1; }
+    topo_load(topo); aff->policy = policy; aff->count = topo_order(topo, policy, aff->order, TOPO_MAX_CPUS);
+    if(!csv){
+        printf("Topología: %d CPUs, %d núcleos físicos, %d paquetes, %d nodos NUMA\n", topo->num_cpus, topo->num_cores, topo->num_packages, topo->num_nodes);
+        printf("Afinidad: %s", topo_policy_name(policy));
+        if(aff->count>0){ printf(" (CPUs:"); for(int w=0;w<workers;w++) printf(" %d", aff->order[w % aff->count]); printf(")"); }
+        printf("\n");
+    }
+    free(topo);
+
+    // Registro por fases (PHASE_LOG); en el barrido las fases se acumulan entre tamaños
+    pt_run_t run; pt_init(&run, "matrix_mult_all");
+    pt_param(&run, "n", n); pt_param(&run, "workers", workers); pt_param(&run, "sweep", sweep);
 
-    // Memoria compartida para procesos (contigua)
+    // Pool de procesos primero: el fork se hace antes de crear hilos. La arena
+    // compartida guarda A, B, C, el planificador y los argumentos de los trabajos.
+    pt_begin(&run, "pool_start");
     size_t bytes = (size_t)n * n * sizeof(int);
-    int *A1 = mmap(NULL, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
-    int *B1 = mmap(NULL, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
-    int *C_proc = mmap(NULL, bytes, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
-    if(A1==MAP_FAILED||B1==MAP_FAILED||C_proc==MAP_FAILED){ perror("mmap"); return 1; }
-    // Copiar A,B al formato 1D
-    for(int i=0;i<n;i++) for(int j=0;j<n;j++){ A1[i*n+j]=A[i][j]; B1[i*n+j]=B[i][j]; }
-
-    // ===== Secuencial =====
-    printf("\n--- Secuencial ---\n");
-    double s_user = get_user_time(); double s_wall = get_wall_time();
-    matmul_seq(A,B,C_seq,n);
-    double e_user = get_user_time(); double e_wall = get_wall_time();
-    double seq_user = e_user - s_user; double seq_wall = e_wall - s_wall;
-    printf("Tiempo usuario: %.6f s\n", seq_user);
-    printf("Tiempo pared : %.6f s\n", seq_wall);
+    size_t arena = pp_arena_bytes(bytes,4) + pp_arena_bytes(ts_bytes(workers),2) + pp_arena_bytes(sizeof(proc_data_t),1) + pp_arena_bytes(sizeof(hybrid_ctl_t),1);
+    double pool_start = get_wall_time();
+    pp_pool_t *pool = pp_create_ex(workers, arena, pin_worker, aff);
+    if(!pool){ fprintf(stderr,"Fallo al crear el pool de procesos\n"); return 1; }
+    // Después del fork: los hijos del pool no heredan el handler (los nodos del híbrido sí,
+    // pero terminan con _exit)
+    live_pool = pool; atexit(stop_workers);
+    double pool_wall = get_wall_time() - pool_start;
+    pt_begin(&run, "alloc");
+    proc_data_t *pd = pp_arena_alloc(pool, sizeof(proc_data_t));
+    pd->A = pp_arena_alloc(pool, bytes); pd->B = pp_arena_alloc(pool, bytes); pd->C = pp_arena_alloc(pool, bytes);
+    pd->sched = pp_arena_alloc(pool, ts_bytes(workers)); pd->n = n; pd->aff = aff;
+    int *C_proc = pd->C;
+    int *C_hyb = pp_arena_alloc(pool, bytes); ts_sched_t *hy_sched = pp_arena_alloc(pool, ts_bytes(workers));
+    hybrid_ctl_t *hy = pp_arena_alloc(pool, sizeof(hybrid_ctl_t));
+    // Los hijos ya leyeron la arena al arrancar; el padre escribe una vez las matrices
+    memset(pd->A,0,bytes); memset(pd->B,0,bytes); memset(C_proc,0,bytes); memset(C_hyb,0,bytes);
+
+    // Matrices para seq/pthreads
+    int **A = allocate_matrix(n); int **B = allocate_matrix(n); int **C_thr = allocate_matrix(n);
+    if(!A||!B||!C_thr){ fprintf(stderr,"Fallo al reservar memoria (int**)\n"); return 1; }
+    prefault_matrix(A,n); prefault_matrix(B,n); prefault_matrix(C_thr,n);
+
+    // Procesos por nodo NUMA: también antes de crear hilos en este proceso
+    topo_node_t *nodes = (topo_node_t*)malloc(TOPO_MAX_NODES * sizeof(topo_node_t));
+    int num_nodes = nodes ? topo_numa_nodes(nodes, TOPO_MAX_NODES) : 0;
+    pt_begin(&run, "pool_start");
+    if(!nodes || !hybrid_start(hy,nodes,num_nodes,workers,n,pd->A,pd->B,C_hyb,hy_sched)){ fprintf(stderr,"Fallo al iniciar el modo híbrido\n"); return 1; }
+    live_hybrid = hy;
+
+    double s_user, s_wall, e_user, e_wall;
+    tp_pool_t *tp = tp_global_ex(workers, pin_worker, aff); // Los hilos se crean una vez, fuera de la medición
+    // worker_cpu_s: hilos del pool, luego procesos del pool, luego un proceso por nodo del híbrido
+    if(tp) pt_watch_threads(&run, tp->threads, tp->num_workers);
+    pt_watch_processes(&run, pool->pids, pool->num_workers);
+    pt_watch_processes(&run, hy->pids, hy->num_nodes);
+
+    if(csv){
+        int ok = 1;
+        if(sweep){
+            // Mismas semillas para todos los tamaños; las entradas se cargan una vez por tamaño
+            printf(CSV_HEADER "\n");
+            for(int s=0;s<num_sizes && ok;s++){
+                pt_begin(&run, "init");
+                load_inputs(A,B,pd,hy,sizes[s],seedA,seedB);
+                pt_begin(&run, "measure");
+                for(int w=0;w<num_wlist && ok;w++) for(int r=0;r<runs && ok;r++) ok = csv_row(tp,pool,pd,hy,A,B,C_thr,C_hyb,sizes[s],wlist[w],run_id++,policy);
+            }
+        } else {
+            pt_begin(&run, "init");
+            load_inputs(A,B,pd,hy,n,seedA,seedB);
+            pt_begin(&run, "measure");
+            ok = csv_row(tp,pool,pd,hy,A,B,C_thr,C_hyb,n,workers,run_id,policy);
+        }
+        pt_begin(&run, "teardown");
+        free_matrix(A,n); free_matrix(B,n); free_matrix(C_thr,n); stop_workers(); free(nodes); free(aff);
+        pt_emit(&run);
+        return ok ? 0 : 1;
+    }
+    pt_begin(&run, "init");
+    load_inputs(A,B,pd,hy,n,seedA,seedB);
+
+    // ===== Secuencial (o referencia desde la caché en disco) =====
+    pt_begin(&run, "reference");
+    ref_entry_t ref;
+    if(!ref_entry_init(&ref,n,seedA,seedB,"int")){ fprintf(stderr,"Fallo al reservar memoria (referencia)\n"); return 1; }
+    double seq_wall;
+    if(ref_cache_load(&ref)){
+        printf("\n--- Secuencial (caché) ---\n");
+        seq_wall = ref.seq_wall;
+        printf("Tiempo pared : %.6f s\n", seq_wall);
+    } else {
+        printf("\n--- Secuencial ---\n");
+        int **C_seq = allocate_matrix(n);
+        if(!C_seq){ fprintf(stderr,"Fallo al reservar memoria (int**)\n"); return 1; }
+        s_user = get_user_time(); s_wall = get_wall_time();
+        matmul_seq(A,B,C_seq,n);
+        e_user = get_user_time(); e_wall = get_wall_time();
+        double seq_user = e_user - s_user; seq_wall = e_wall - s_wall;
+        printf("Tiempo usuario: %.6f s\n", seq_user);
+        printf("Tiempo pared : %.6f s\n", seq_wall);
+        ref.seq_wall = seq_wall;
+        for(int i=0;i<n;i++){ for(int j=0;j<n;j++) ref.checksum += C_seq[i][j]; ref.row_hash[i] = ref_row_hash_int(C_seq[i],n); }
+        ref_cache_store(&ref);
+        free_matrix(C_seq,n);
+    }
     printf("GFLOPS (wall): %.6f\n", (2.0 * n * (double)n * (double)n) / (seq_wall * 1e9));
 
     // ===== Pthreads =====
+    pt_begin(&run, "threads");
     printf("\n--- Paralelo (Hilos) ---\n");
     s_user = get_user_time(); s_wall = get_wall_time();
-    matmul_pthreads(A,B,C_thr,n,workers);
+    matmul_pthreads(tp,A,B,C_thr,n,workers,pd->sched,aff);
     e_user = get_user_time(); e_wall = get_wall_time();
     double thr_user = e_user - s_user; double thr_wall = e_wall - s_wall;
     printf("Tiempo usuario: %.6f s\n", thr_user);
@@ -153,11 +467,14 @@ int main(int argc,char *argv[]){
     double speedup_thr = seq_wall / thr_wall;
     printf("Speedup (wall): %.2fx\n", speedup_thr);
     printf("Eficiencia: %.2f%%\n", (speedup_thr / workers) * 100.0);
+    ts_report(pd->sched, "Hilo");
 
     // ===== Procesos =====
+    pt_begin(&run, "processes");
     printf("\n--- Paralelo (Procesos) ---\n");
+    printf("Arranque del pool (fork, no medido): %.6f s\n", pool_wall);
     s_user = get_user_time(); s_wall = get_wall_time();
-    matmul_process(A1,B1,C_proc,n,workers);
+    matmul_process(pool,pd,workers);
     e_user = get_user_time(); e_wall = get_wall_time();
     double proc_user = e_user - s_user; double proc_wall = e_wall - s_wall;
     printf("Tiempo usuario (padre): %.6f s\n", proc_user);
@@ -166,25 +483,51 @@ int main(int argc,char *argv[]){
     double speedup_proc = seq_wall / proc_wall;
     printf("Speedup (wall): %.2fx\n", speedup_proc);
     printf("Eficiencia: %.2f%%\n", (speedup_proc / workers) * 100.0);
+    ts_report(pd->sched, "Proceso");
+
+    // ===== Híbrido =====
+    pt_begin(&run, "hybrid");
+    printf("\n--- Paralelo (Híbrido: proceso por nodo NUMA + hilos) ---\n");
+    printf("Nodos NUMA: %d (usados %d). Hilos por nodo:", num_nodes, hy->num_nodes);
+    for(int d=0;d<hy->num_nodes;d++) printf(" nodo%d=%d", nodes[d].id, hy->num_threads[d]);
+    printf("\n");
+    s_user = get_user_time(); s_wall = get_wall_time();
+    matmul_hybrid(hy);
+    e_user = get_user_time(); e_wall = get_wall_time();
+    double hyb_wall = e_wall - s_wall;
+    printf("Tiempo usuario (padre): %.6f s\n", e_user - s_user);
+    printf("Tiempo pared           : %.6f s\n", hyb_wall);
+    printf("GFLOPS (wall): %.6f\n", (2.0 * n * (double)n * (double)n) / (hyb_wall * 1e9));
+    double speedup_hyb = seq_wall / hyb_wall;
+    printf("Speedup (wall): %.2fx\n", speedup_hyb);
+    printf("Eficiencia: %.2f%%\n", (speedup_hyb / workers) * 100.0);
+    ts_report(hy_sched, "Hilo");
 
     // ===== Verificación =====
+    pt_begin(&run, "verify");
     printf("\nVerificando resultados...\n");
-    if(verify_all(C_seq,C_thr,C_proc,n)) printf("✓ Resultados idénticos en las tres versiones\n"); else printf("✗ Diferencias detectadas\n");
+    if(verify_all(&ref,C_thr,C_proc,C_hyb,n)) printf("✓ Resultados idénticos en las cuatro versiones\n"); else printf("✗ Diferencias detectadas\n");
 
-    long long sum_seq=0,sum_thr=0,sum_proc=0;
-    for(int i=0;i<n;i++) for(int j=0;j<n;j++){ sum_seq += C_seq[i][j]; sum_thr += C_thr[i][j]; sum_proc += C_proc[i*n + j]; }
+    long long sum_seq=ref.checksum,sum_thr=0,sum_proc=0,sum_hyb=0;
+    for(int i=0;i<n;i++) for(int j=0;j<n;j++){ sum_thr += C_thr[i][j]; sum_proc += C_proc[i*n + j]; sum_hyb += C_hyb[i*n + j]; }
     printf("Suma secuencial: %lld\n", sum_seq);
     printf("Suma hilos     : %lld\n", sum_thr);
     printf("Suma procesos  : %lld\n", sum_proc);
+    printf("Suma híbrido   : %lld\n", sum_hyb);
 
     printf("\n=== RESUMEN (Wall) ===\n");
     printf("Secuencial: %.6f s\n", seq_wall);
     printf("Hilos     : %.6f s  (Speedup %.2fx)\n", thr_wall, speedup_thr);
     printf("Procesos  : %.6f s  (Speedup %.2fx)\n", proc_wall, speedup_proc);
-    if(thr_wall < proc_wall) printf("Mejor: Hilos\n"); else if(proc_wall < thr_wall) printf("Mejor: Procesos\n"); else printf("Empate\n");
+    printf("Híbrido   : %.6f s  (Speedup %.2fx)\n", hyb_wall, speedup_hyb);
+    if(thr_wall < proc_wall && thr_wall < hyb_wall) printf("Mejor: Hilos\n");
+    else if(proc_wall < thr_wall && proc_wall < hyb_wall) printf("Mejor: Procesos\n");
+    else if(hyb_wall < thr_wall && hyb_wall < proc_wall) printf("Mejor: Híbrido\n");
+    else printf("Empate\n");
 
     // Liberar memoria
-    free_matrix(A,n); free_matrix(B,n); free_matrix(C_seq,n); free_matrix(C_thr,n);
-    munmap(A1,bytes); munmap(B1,bytes); munmap(C_proc,bytes);
+    pt_begin(&run, "teardown");
+    free_matrix(A,n); free_matrix(B,n); free_matrix(C_thr,n); ref_entry_free(&ref); stop_workers(); free(nodes); free(aff);
+    pt_emit(&run);
     return 0;
 }
@@ -1,23 +1,52 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
 #include <signal.h>
 #include <errno.h>
+#include "reference_cache.h"
+#include "tile_scheduler.h"
+#include "process_pool.h"
+#include "phase_timer.h"
 
-// Estructura para datos compartidos entre procesos
+#define HUGE_PAGE_BYTES (2UL << 20)
+
+// Fallos de página de un proceso hijo (una línea de caché por hijo)
+typedef struct {
+    int pid;
+    long prep_minflt, prep_majflt;   // Al mapear entradas y ventana (solo motor memfd)
+    long minflt, majflt;             // Durante el cálculo
+    char pad[20];
+} child_faults_t;
+
+// Datos compartidos por los trabajos del pool (viven en su arena compartida)
 typedef struct {
+    int *A, *B, *C;     // Matrices en la arena (motor por defecto)
     int size;           // Tamaño de la matriz
     int num_processes;  // Número de procesos
-    int process_id;     // ID del proceso
-    int start_row;      // Fila inicial para este proceso
-    int end_row;        // Fila final para este proceso
+    ts_sched_t *sched;  // Planificador de teselas compartido
+    child_faults_t *faults;          // Un registro por trabajo
+    // Motor memfd: descriptores heredados en el fork y barrera de todos los hijos
+    int use_memfd;
+    int in_fd, out_fd;
+    size_t in_bytes;
+    pthread_barrier_t *barrier;
+    int failed;
 } process_data_t;
 
+// Mapeos de cada hijo en el motor memfd (memoria privada de cada proceso)
+static int child_slot = -1;
+static const int *child_A, *child_B;
+static int *child_C;                 // Apunta a la fila row_begin de C
+static int child_row_begin, child_row_end;
+
 // Función para obtener tiempo de usuario en segundos
 double get_user_time() {
     struct rusage usage;
@@ -25,11 +54,17 @@ double get_user_time() {
     return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
 }
 
-// Función para obtener tiempo de reloj de pared
+// Función para obtener tiempo de reloj de pared (monotónico, el mismo de phase_timer.h)
 double get_wall_time() {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+    return pt_now();
+}
+
+// Fallos de página menores y mayores acumulados por este proceso
+void read_faults(long *minflt, long *majflt) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    *minflt = usage.ru_minflt;
+    *majflt = usage.ru_majflt;
 }
 
 // Función para inicializar una matriz con valores aleatorios
@@ -81,120 +116,225 @@ double matrix_multiply_sequential(int *A, int *B, int *C, int size) {
     return end_time - start_time;
 }
 
-// Función que ejecuta cada proceso hijo
-int process_matrix_multiply(int *A, int *B, int *C, process_data_t *data) {
+// Función que ejecuta cada trabajo del pool: el trabajo `id` pide teselas al
+// planificador compartido hasta que no quedan, así un proceso lento no retiene al resto
+void process_matrix_multiply(void *arg, int begin, int end) {
+    process_data_t *data = (process_data_t*)arg;
     int size = data->size;
-    int start_row = data->start_row;
-    int end_row = data->end_row;
-    int process_id = data->process_id;
-    
-    printf("Proceso %d (PID: %d): procesando filas %d a %d\n", 
-           process_id, getpid(), start_row, end_row - 1);
+    int *A = data->A, *B = data->B, *C = data->C;
     
-    // Cada proceso calcula su porción de filas
-    for (int i = start_row; i < end_row; i++) {
-        for (int j = 0; j < size; j++) {
-            C[i * size + j] = 0;
-            for (int k = 0; k < size; k++) {
-                C[i * size + j] += A[i * size + k] * B[k * size + j];
+    for (int process_id = begin; process_id < end; process_id++) {
+        int first, count;
+        long minflt, majflt;
+        read_faults(&minflt, &majflt);
+        printf("Proceso %d (PID: %d): iniciado\n", process_id, getpid());
+        
+        while (ts_next(data->sched, process_id, &first, &count)) {
+            for (int t = first; t < first + count; t++) {
+                int i0, i1, j0, j1;
+                ts_tile_bounds(data->sched, t, &i0, &i1, &j0, &j1);
+                for (int i = i0; i < i1; i++) {
+                    for (int j = j0; j < j1; j++) {
+                        C[i * size + j] = 0;
+                        for (int k = 0; k < size; k++) {
+                            C[i * size + j] += A[i * size + k] * B[k * size + j];
+                        }
+                    }
+                }
             }
         }
+        
+        child_faults_t *f = &data->faults[process_id];
+        read_faults(&f->minflt, &f->majflt);
+        f->minflt -= minflt;
+        f->majflt -= majflt;
+        f->pid = getpid();
+        printf("Proceso %d completado\n", process_id);
+        // Los hijos del pool terminan con _exit: la salida se vacía aquí
+        fflush(stdout);
     }
-    
-    printf("Proceso %d completado\n", process_id);
-    return 0;
 }
 
-// Función de multiplicación paralela con procesos
-double matrix_multiply_parallel(int *A, int *B, int *C, int size, int num_processes) {
-    pid_t *pids;
-    process_data_t *process_data;
-    int rows_per_process, remaining_rows;
-    double start_time, end_time;
-    
-    // Allocar memoria y datos de procesos
-    pids = malloc(num_processes * sizeof(pid_t));
-    process_data = allocate_shared_memory(num_processes * sizeof(process_data_t));
-    
-    if (pids == NULL || process_data == NULL) {
-        printf("Error: No se pudo allocar memoria para procesos\n");
-        return -1.0;
+// ===================== Motor memfd =====================
+// A y B van en un memfd que el padre escribe, desmapea y sella (F_SEAL_WRITE):
+// después nadie puede modificarlas y cada hijo las mapea solo lectura con
+// MAP_POPULATE, así que sus tablas de páginas quedan completas antes de medir.
+// Si hay páginas enormes reservadas el memfd usa MFD_HUGETLB; si no, páginas
+// normales con MADV_HUGEPAGE (THP de shmem, si el sistema lo permite).
+// C va en otro memfd: cada hijo mapea solo la ventana de filas que calcula.
+
+// Redondea bytes hacia arriba a un múltiplo de unit
+size_t round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+// Crea el memfd de entradas antes del fork para que los hijos hereden el descriptor.
+// No deja mapeos abiertos: F_SEAL_WRITE falla si existe algún mapeo compartido con
+// escritura, incluidos los heredados por los hijos. Devuelve -1 si falla.
+int create_input_memfd(size_t bytes, size_t *mapped_bytes, int *huge) {
+    int fd = memfd_create("matmul_inputs", MFD_CLOEXEC | MFD_ALLOW_SEALING | MFD_HUGETLB);
+    if (fd >= 0) {
+        // mmap falla si no hay páginas enormes reservadas para todo el tamaño
+        size_t huge_bytes = round_up(bytes, HUGE_PAGE_BYTES);
+        void *probe = MAP_FAILED;
+        if (ftruncate(fd, huge_bytes) == 0) {
+            probe = mmap(NULL, huge_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (probe != MAP_FAILED) {
+            munmap(probe, huge_bytes);
+            *mapped_bytes = huge_bytes;
+            *huge = 1;
+            return fd;
+        }
+        close(fd);
     }
-    
-    // Calcular distribución de trabajo
-    rows_per_process = size / num_processes;
-    remaining_rows = size % num_processes;
-    
-    printf("Distribución: %d filas por proceso, %d filas extras\n", 
-           rows_per_process, remaining_rows);
-    
-    // Iniciar medición de tiempo
-    start_time = get_wall_time();
-    
-    // Crear procesos hijos
-    int current_row = 0;
-    for (int i = 0; i < num_processes; i++) {
-        process_data[i].size = size;
-        process_data[i].num_processes = num_processes;
-        process_data[i].process_id = i;
-        process_data[i].start_row = current_row;
-        
-        // Distribuir filas extras entre los primeros procesos
-        int extra_row = (i < remaining_rows) ? 1 : 0;
-        process_data[i].end_row = current_row + rows_per_process + extra_row;
-        
-        current_row = process_data[i].end_row;
-        
-        // Crear proceso hijo
-        pids[i] = fork();
-        
-        if (pids[i] == -1) {
-            perror("fork");
-            // Limpiar procesos ya creados
-            for (int j = 0; j < i; j++) {
-                kill(pids[j], SIGTERM);
-                waitpid(pids[j], NULL, 0);
-            }
-            free(pids);
-            free_shared_memory(process_data, num_processes * sizeof(process_data_t));
-            return -1.0;
+    fd = memfd_create("matmul_inputs", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    *mapped_bytes = round_up(bytes, (size_t)sysconf(_SC_PAGESIZE));
+    *huge = 0;
+    if (fd < 0 || ftruncate(fd, *mapped_bytes) != 0) {
+        perror("memfd_create");
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// El padre escribe A y B en el memfd, desmapea y sella. 1 si quedó sellado.
+int fill_and_seal_inputs(process_data_t *data, int seed_A, int seed_B) {
+    size_t matrix_size = (size_t)data->size * data->size * sizeof(int);
+    int *inputs = (int*)mmap(NULL, data->in_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, data->in_fd, 0);
+    if (inputs == MAP_FAILED) {
+        perror("mmap");
+        return 0;
+    }
+    madvise(inputs, data->in_bytes, MADV_HUGEPAGE);
+    initialize_matrix(inputs, data->size, seed_A);
+    initialize_matrix((int*)((char*)inputs + matrix_size), data->size, seed_B);
+    munmap(inputs, data->in_bytes);
+    if (fcntl(data->in_fd, F_ADD_SEALS, F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        perror("F_ADD_SEALS");
+        return 0;
+    }
+    return 1;
+}
+
+// Mapea las filas [row_begin, row_end) de C desde el memfd de resultados. El inicio
+// se baja al límite de página anterior; devuelve el puntero a la fila row_begin.
+int* map_row_window(int fd, int size, int row_begin, int row_end, int prot, int populate) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t row_bytes = (size_t)size * sizeof(int);
+    size_t start = (size_t)row_begin * row_bytes, end = (size_t)row_end * row_bytes;
+    size_t offset = start / page * page;
+    char *window = (char*)mmap(NULL, end - offset, prot, MAP_SHARED | (populate ? MAP_POPULATE : 0), fd, (off_t)offset);
+    if (window == MAP_FAILED) return NULL;
+    return (int*)(window + (start - offset));
+}
+
+// Primer trabajo de cada hijo: toma un hueco, mapea entradas y su ventana de C.
+// La barrera de num_processes participantes obliga a que cada hijo tome exactamente
+// un trabajo (ninguno puede tomar un segundo hasta que todos tengan el suyo).
+void memfd_prepare(void *arg, int begin, int end) {
+    process_data_t *data = (process_data_t*)arg;
+    int size = data->size;
+    for (int slot = begin; slot < end; slot++) {
+        long minflt, majflt;
+        read_faults(&minflt, &majflt);
+        child_slot = slot;
+        child_row_begin = (int)((long long)slot * size / data->num_processes);
+        child_row_end = (int)((long long)(slot + 1) * size / data->num_processes);
+        const int *inputs = (const int*)mmap(NULL, data->in_bytes, PROT_READ, MAP_SHARED | MAP_POPULATE, data->in_fd, 0);
+        if (inputs == MAP_FAILED) {
+            __atomic_store_n(&data->failed, 1, __ATOMIC_RELEASE);
+        } else {
+            child_A = inputs;
+            child_B = inputs + (size_t)size * size;
         }
-        else if (pids[i] == 0) {
-            // Código del proceso hijo
-            int result = process_matrix_multiply(A, B, C, &process_data[i]);
-            exit(result);
+        if (child_row_end > child_row_begin) {
+            child_C = map_row_window(data->out_fd, size, child_row_begin, child_row_end,
+                                     PROT_READ | PROT_WRITE, 1);
+            if (child_C == NULL) __atomic_store_n(&data->failed, 1, __ATOMIC_RELEASE);
         }
-        // El proceso padre continúa el bucle para crear más hijos
+        child_faults_t *f = &data->faults[slot];
+        read_faults(&f->prep_minflt, &f->prep_majflt);
+        f->prep_minflt -= minflt;
+        f->prep_majflt -= majflt;
+        f->pid = getpid();
+        pthread_barrier_wait(data->barrier);
     }
-    
-    // El proceso padre espera a todos los hijos
-    int all_success = 1;
-    for (int i = 0; i < num_processes; i++) {
-        int status;
-        waitpid(pids[i], &status, 0);
-        
-        if (WIFEXITED(status)) {
-            int exit_code = WEXITSTATUS(status);
-            if (exit_code != 0) {
-                printf("Proceso %d terminó con error: %d\n", i, exit_code);
-                all_success = 0;
+}
+
+// Trabajo de cálculo: cada hijo calcula sus filas en su ventana. La barrera inicial
+// vuelve a repartir un trabajo por hijo; el índice del trabajo no importa, cada
+// hijo usa el hueco que tomó en memfd_prepare.
+void memfd_multiply(void *arg, int begin, int end) {
+    process_data_t *data = (process_data_t*)arg;
+    int size = data->size;
+    for (int job = begin; job < end; job++) {
+        pthread_barrier_wait(data->barrier);
+        long minflt, majflt;
+        read_faults(&minflt, &majflt);
+        printf("Proceso %d (PID: %d): filas %d-%d\n", child_slot, getpid(), child_row_begin, child_row_end - 1);
+        for (int i = child_row_begin; i < child_row_end; i++) {
+            int *row = &child_C[(size_t)(i - child_row_begin) * size];
+            for (int j = 0; j < size; j++) {
+                int sum = 0;
+                for (int k = 0; k < size; k++) {
+                    sum += child_A[(size_t)i * size + k] * child_B[(size_t)k * size + j];
+                }
+                row[j] = sum;
             }
+        }
+        child_faults_t *f = &data->faults[child_slot];
+        read_faults(&f->minflt, &f->majflt);
+        f->minflt -= minflt;
+        f->majflt -= majflt;
+        fflush(stdout);
+    }
+}
+
+// Fallos de página por hijo (el hijo los mide con getrusage sobre sí mismo)
+void report_faults(const process_data_t *data) {
+    printf("Fallos de página por proceso (menores/mayores):\n");
+    for (int p = 0; p < data->num_processes; p++) {
+        const child_faults_t *f = &data->faults[p];
+        if (data->use_memfd) {
+            printf("  Proceso %d (PID: %d): mapeo %ld/%ld, cálculo %ld/%ld\n", p, f->pid,
+                   f->prep_minflt, f->prep_majflt, f->minflt, f->majflt);
         } else {
-            printf("Proceso %d terminó anormalmente\n", i);
-            all_success = 0;
+            printf("  Proceso %d (PID: %d): cálculo %ld/%ld\n", p, f->pid, f->minflt, f->majflt);
         }
     }
+}
+
+// Función de multiplicación paralela con el pool de procesos ya creado
+double matrix_multiply_parallel(pp_pool_t *pool, process_data_t *data) {
+    double start_time, end_time;
+    
+    if (data->use_memfd) {
+        printf("Distribución: ventana fija de filas por proceso (memfd)\n");
+    } else {
+        // Distribución dinámica por teselas de C
+        ts_init(data->sched, data->size, data->size, 0, 0, data->num_processes);
+        printf("Distribución: dinámica, %d teselas de %dx%d (trozos guiados)\n", 
+               data->sched->total_tiles, data->sched->tile_rows, data->sched->tile_cols);
+    }
+    fflush(stdout);
+    
+    // Iniciar medición de tiempo
+    start_time = get_wall_time();
+    
+    // Un trabajo por proceso en el anillo compartido; el padre espera a que terminen
+    int all_success = pp_parallel_for(pool, 0, data->num_processes, 1,
+                                      data->use_memfd ? memfd_multiply : process_matrix_multiply, data);
     
     // Terminar medición de tiempo
     end_time = get_wall_time();
     
-    // Liberar memoria
-    free(pids);
-    free_shared_memory(process_data, num_processes * sizeof(process_data_t));
-    
     if (!all_success) {
+        printf("Un proceso del pool terminó anormalmente\n");
         return -1.0;
     }
+    if (!data->use_memfd) ts_report(data->sched, "Proceso");
     
     printf("Tiempo paralelo (procesos) - Reloj: %.6f s\n", end_time - start_time);
     
@@ -203,52 +343,87 @@ double matrix_multiply_parallel(int *A, int *B, int *C, int size, int num_proces
 
 // Función para mostrar ayuda
 void print_usage(char *program_name) {
-    printf("Uso: %s <tamaño_matriz> [num_procesos] [semilla_A] [semilla_B]\n", program_name);
+    printf("Uso: %s <tamaño_matriz> [num_procesos] [semilla_A] [semilla_B] [--memfd] [--faults]\n", program_name);
     printf("  tamaño_matriz: Tamaño de las matrices cuadradas (obligatorio)\n");
     printf("  num_procesos: Número de procesos a usar (opcional, por defecto: número de CPUs)\n");
     printf("  semilla_A: Semilla para generar matriz A (opcional, por defecto: tiempo actual)\n");
     printf("  semilla_B: Semilla para generar matriz B (opcional, por defecto: tiempo actual + 1)\n");
+    printf("  --memfd: A y B en un memfd sellado de solo lectura, C en ventanas de filas por proceso\n");
+    printf("  --faults: fallos de página de cada proceso hijo (getrusage)\n");
     printf("\nEjemplos:\n");
     printf("  %s 512           # Matriz 512x512, procesos automáticos\n", program_name);
     printf("  %s 1000 4        # Matriz 1000x1000, 4 procesos\n", program_name);
     printf("  %s 512 8 123 456 # Matriz 512x512, 8 procesos, semillas específicas\n", program_name);
+    printf("  %s 512 4 123 456 --memfd --faults\n", program_name);
 }
 
-// Función para verificar que los resultados son iguales
-int verify_results(int *C_seq, int *C_par, int size) {
-    for (int i = 0; i < size * size; i++) {
-        if (C_seq[i] != C_par[i]) {
-            int row = i / size;
-            int col = i % size;
-            printf("Error en verificación: C_seq[%d][%d]=%d != C_par[%d][%d]=%d\n",
-                   row, col, C_seq[i], row, col, C_par[i]);
+// Función para verificar el resultado paralelo contra el hash por fila de la referencia
+int verify_results(const ref_entry_t *ref, int *C_par, int size) {
+    for (int i = 0; i < size; i++) {
+        if (!ref_check_row_int(ref, i, &C_par[i * size])) {
+            printf("Error en verificación: la fila %d no coincide con la referencia secuencial\n", i);
             return 0;
         }
     }
     return 1;
 }
 
+// Obtiene la referencia secuencial de la caché en disco o la calcula y la guarda
+int load_or_build_reference(ref_entry_t *ref, int *A, int *B, int *C_seq, int size) {
+    if (ref_cache_load(ref)) {
+        printf("Referencia secuencial: caché (%.6f s)\n", ref->seq_wall);
+        return 1;
+    }
+    printf("Referencia secuencial: no está en caché, calculando...\n");
+    ref->seq_wall = matrix_multiply_sequential(A, B, C_seq, size);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            ref->checksum += C_seq[i * size + j];
+        }
+        ref->row_hash[i] = ref_row_hash_int(&C_seq[i * size], size);
+    }
+    ref_cache_store(ref);
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     int size, num_processes;
     int seed_A, seed_B;
     double parallel_time;
+    int use_memfd = 0, show_faults = 0;
+    char *pos[4];
+    int npos = 0;
+    
+    // Separar opciones de argumentos posicionales
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--memfd") == 0) {
+            use_memfd = 1;
+        } else if (strcmp(argv[a], "--faults") == 0) {
+            show_faults = 1;
+        } else if (argv[a][0] != '-' && npos < 4) {
+            pos[npos++] = argv[a];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
     
     // Verificar argumentos de línea de comandos
-    if (argc < 2 || argc > 5) {
+    if (npos < 1) {
         print_usage(argv[0]);
         return 1;
     }
     
     // Obtener tamaño de la matriz
-    size = atoi(argv[1]);
+    size = atoi(pos[0]);
     if (size <= 0) {
         printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
         return 1;
     }
     
     // Obtener número de procesos
-    if (argc >= 3) {
-        num_processes = atoi(argv[2]);
+    if (npos >= 2) {
+        num_processes = atoi(pos[1]);
         if (num_processes <= 0) {
             printf("Error: El número de procesos debe ser positivo.\n");
             return 1;
@@ -260,14 +435,14 @@ int main(int argc, char *argv[]) {
     }
     
     // Obtener semillas para la generación aleatoria
-    if (argc >= 4) {
-        seed_A = atoi(argv[3]);
+    if (npos >= 3) {
+        seed_A = atoi(pos[2]);
     } else {
         seed_A = (int)time(NULL);
     }
     
-    if (argc == 5) {
-        seed_B = atoi(argv[4]);
+    if (npos == 4) {
+        seed_B = atoi(pos[3]);
     } else {
         seed_B = seed_A + 1;
     }
@@ -277,84 +452,188 @@ int main(int argc, char *argv[]) {
     printf("Número de procesos: %d\n", num_processes);
     printf("Semilla matriz A: %d\n", seed_A);
     printf("Semilla matriz B: %d\n", seed_B);
-    printf("Allocando memoria compartida...\n");
+    printf("Motor: %s\n", use_memfd ? "memfd sellado + ventanas de filas" : "arena compartida + teselas dinámicas");
+    printf("Allocando memoria compartida y arrancando el pool de procesos...\n");
     
     // Calcular tamaño total de memoria necesaria
-    size_t matrix_size = size * size * sizeof(int);
+    size_t matrix_size = (size_t)size * size * sizeof(int);
+    
+    pt_run_t run;
+    pt_init(&run, "matrix_mult_processes");
+    pt_param(&run, "n", size);
+    pt_param(&run, "procs", num_processes);
+    pt_param(&run, "memfd", use_memfd);
+    
+    // Motor memfd: los memfd se crean antes del fork para que los hijos hereden los descriptores
+    int in_fd = -1, out_fd = -1, huge = 0;
+    size_t in_bytes = 0, out_bytes = round_up(matrix_size, (size_t)sysconf(_SC_PAGESIZE));
+    if (use_memfd) {
+        in_fd = create_input_memfd(2 * matrix_size, &in_bytes, &huge);
+        out_fd = memfd_create("matmul_result", MFD_CLOEXEC);
+        if (in_fd < 0 || out_fd < 0 || ftruncate(out_fd, out_bytes) != 0) {
+            printf("Error: No se pudieron crear los memfd de entradas y resultado.\n");
+            return 1;
+        }
+    }
     
-    // Alocar memoria compartida para las matrices (usando representación contigua)
-    int *A = (int*)allocate_shared_memory(matrix_size);
-    int *B = (int*)allocate_shared_memory(matrix_size);
-    int *C_sequential = (int*)allocate_shared_memory(matrix_size);
-    int *C_parallel = (int*)allocate_shared_memory(matrix_size);
+    // Los hijos se crean una vez, antes de medir. A, B, C paralela (motor por defecto),
+    // el planificador, los fallos por hijo y los datos de los trabajos van en la arena compartida.
+    size_t arena_bytes = pp_arena_bytes(matrix_size, use_memfd ? 0 : 3) + pp_arena_bytes(ts_bytes(num_processes), 1) +
+                         pp_arena_bytes(sizeof(process_data_t), 1) +
+                         pp_arena_bytes(sizeof(child_faults_t) * num_processes, 1) +
+                         pp_arena_bytes(sizeof(pthread_barrier_t), 1);
+    pt_begin(&run, "pool_start");
+    double pool_start = get_wall_time();
+    pp_pool_t *pool = pp_create(num_processes, arena_bytes);
+    if (pool == NULL) {
+        printf("Error: No se pudo crear el pool de procesos.\n");
+        return 1;
+    }
+    printf("Pool listo en %.6f s (fork y mapeo de la arena, fuera de la medición)\n", get_wall_time() - pool_start);
+    // worker_cpu_s: un valor por hijo del pool
+    pt_watch_processes(&run, pool->pids, pool->num_workers);
+    
+    pt_begin(&run, "alloc");
+    
+    process_data_t *data = (process_data_t*)pp_arena_alloc(pool, sizeof(process_data_t));
+    data->sched = (ts_sched_t*)pp_arena_alloc(pool, ts_bytes(num_processes));
+    data->faults = (child_faults_t*)pp_arena_alloc(pool, sizeof(child_faults_t) * num_processes);
+    data->size = size;
+    data->num_processes = num_processes;
+    data->use_memfd = use_memfd;
+    
+    int *A, *B, *C_parallel = NULL;
+    if (!use_memfd) {
+        A = (int*)pp_arena_alloc(pool, matrix_size);
+        B = (int*)pp_arena_alloc(pool, matrix_size);
+        C_parallel = (int*)pp_arena_alloc(pool, matrix_size);
+        data->A = A;
+        data->B = B;
+        data->C = C_parallel;
+    }
     
-    if (A == NULL || B == NULL || C_sequential == NULL || C_parallel == NULL) {
+    // C secuencial solo la usa el padre
+    int *C_sequential = (int*)allocate_shared_memory(matrix_size);
+    if (C_sequential == NULL) {
         printf("Error: No se pudo alocar memoria compartida para las matrices.\n");
-        if (A) free_shared_memory(A, matrix_size);
-        if (B) free_shared_memory(B, matrix_size);
-        if (C_sequential) free_shared_memory(C_sequential, matrix_size);
-        if (C_parallel) free_shared_memory(C_parallel, matrix_size);
+        pp_destroy(pool);
         return 1;
     }
     
     printf("Inicializando matrices con valores aleatorios...\n");
-    
-    // Inicializar matrices A y B con valores aleatorios
-    initialize_matrix(A, size, seed_A);
-    initialize_matrix(B, size, seed_B);
-    
-    // === EJECUCIÓN SECUENCIAL ===
-    // printf("\n--- Ejecutando versión secuencial ---\n");
-    // sequential_time = matrix_multiply_sequential(A, B, C_sequential, size);
-    
-    // if (sequential_time < 0) {
-    //     printf("Error en ejecución secuencial\n");
-    //     return 1;
-    // }
+    pt_begin(&run, "init");
+    
+    if (use_memfd) {
+        // A y B se escriben en el memfd y se sellan; luego cada hijo mapea entradas y su ventana
+        data->in_fd = in_fd;
+        data->out_fd = out_fd;
+        data->in_bytes = in_bytes;
+        data->barrier = (pthread_barrier_t*)pp_arena_alloc(pool, sizeof(pthread_barrier_t));
+        pthread_barrierattr_t attr;
+        pthread_barrierattr_init(&attr);
+        pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_barrier_init(data->barrier, &attr, num_processes);
+        pthread_barrierattr_destroy(&attr);
+        if (!fill_and_seal_inputs(data, seed_A, seed_B)) {
+            printf("Error: No se pudieron escribir y sellar las entradas.\n");
+            pp_destroy(pool);
+            return 1;
+        }
+        pt_begin(&run, "map");
+        double map_start = get_wall_time();
+        if (!pp_parallel_for(pool, 0, num_processes, 1, memfd_prepare, data) || data->failed) {
+            printf("Error: Un proceso no pudo mapear las entradas o su ventana de C.\n");
+            pp_destroy(pool);
+            return 1;
+        }
+        printf("Entradas: memfd sellado, solo lectura, MAP_POPULATE, %s\n",
+               huge ? "páginas enormes (MFD_HUGETLB)" : "páginas normales (MADV_HUGEPAGE si hay THP de shmem)");
+        printf("Mapeo en los hijos: %.6f s (fuera de la medición)\n", get_wall_time() - map_start);
+        A = (int*)mmap(NULL, in_bytes, PROT_READ, MAP_SHARED, in_fd, 0);
+        if (A == MAP_FAILED) {
+            perror("mmap");
+            pp_destroy(pool);
+            return 1;
+        }
+        B = A + (size_t)size * size;
+    } else {
+        // Inicializar matrices A y B con valores aleatorios
+        initialize_matrix(A, size, seed_A);
+        initialize_matrix(B, size, seed_B);
+    }
     
     // === EJECUCIÓN PARALELA ===
     printf("\n--- Ejecutando versión paralela con procesos ---\n");
-    parallel_time = matrix_multiply_parallel(A, B, C_parallel, size, num_processes);
+    pt_begin(&run, "compute");
+    parallel_time = matrix_multiply_parallel(pool, data);
     
     if (parallel_time < 0) {
         printf("Error en ejecución paralela\n");
+        pp_destroy(pool);
         return 1;
     }
+    if (show_faults) report_faults(data);
+    if (use_memfd) {
+        C_parallel = map_row_window(out_fd, size, 0, size, PROT_READ, 0);
+        if (C_parallel == NULL) {
+            perror("mmap");
+            pp_destroy(pool);
+            return 1;
+        }
+    }
     
-    // Calcular speedup
-    // speedup = sequential_time / parallel_time;
-    // double efficiency = (speedup / num_processes) * 100;
+    // Referencia secuencial (caché en disco) para speedup y verificación
+    printf("\n--- Obteniendo referencia secuencial ---\n");
+    pt_begin(&run, "reference");
+    ref_entry_t ref;
+    if (!ref_entry_init(&ref, size, seed_A, seed_B, "int")) {
+        printf("Error: No se pudo alocar memoria para la referencia\n");
+        pp_destroy(pool);
+        return 1;
+    }
+    load_or_build_reference(&ref, A, B, C_sequential, size);
+    double sequential_time = ref.seq_wall;
+    double speedup = sequential_time / parallel_time;
+    double efficiency = (speedup / num_processes) * 100;
     
     printf("\n=== RESULTADOS ===\n");
-    // printf("Tiempo secuencial: %.6f segundos\n", sequential_time);
+    printf("Tiempo secuencial: %.6f segundos\n", sequential_time);
     printf("Tiempo paralelo: %.6f segundos\n", parallel_time);
-    // printf("Speedup: %.2fx\n", speedup);
-    // printf("Eficiencia: %.2f%% (%d procesos)\n", efficiency, num_processes);
-    // printf("GFLOPS secuencial: %.6f\n", (2.0 * size * size * size) / (sequential_time * 1e9));
+    printf("Speedup: %.2fx\n", speedup);
+    printf("Eficiencia: %.2f%% (%d procesos)\n", efficiency, num_processes);
+    printf("GFLOPS secuencial: %.6f\n", (2.0 * size * size * size) / (sequential_time * 1e9));
     printf("GFLOPS paralelo: %.6f\n", (2.0 * size * size * size) / (parallel_time * 1e9));
     
     // Verificar que los resultados son correctos
     printf("\nVerificando resultados...\n");
-    if (verify_results(C_sequential, C_parallel, size)) {
+    pt_begin(&run, "verify");
+    if (verify_results(&ref, C_parallel, size)) {
         printf("✓ Verificación exitosa: Ambos resultados son idénticos\n");
     } else {
         printf("✗ Error: Los resultados no coinciden\n");
     }
     
     // Calcular suma de verificación
-    long long sum_seq = 0, sum_par = 0;
+    long long sum_seq = ref.checksum, sum_par = 0;
     for (int i = 0; i < size * size; i++) {
-        sum_seq += C_sequential[i];
         sum_par += C_parallel[i];
     }
     printf("Suma verificación secuencial: %lld\n", sum_seq);
     printf("Suma verificación paralela: %lld\n", sum_par);
     
-    // Liberar memoria compartida
-    free_shared_memory(A, matrix_size);
-    free_shared_memory(B, matrix_size);
+    // Detener el pool (libera la arena) y la memoria compartida
+    pt_begin(&run, "teardown");
+    if (use_memfd) pthread_barrier_destroy(data->barrier);
+    pp_destroy(pool);
+    if (use_memfd) {
+        munmap(A, in_bytes);
+        munmap(C_parallel, out_bytes);
+        close(in_fd);
+        close(out_fd);
+    }
     free_shared_memory(C_sequential, matrix_size);
-    free_shared_memory(C_parallel, matrix_size);
+    ref_entry_free(&ref);
+    pt_emit(&run);
     
     return 0;
 }
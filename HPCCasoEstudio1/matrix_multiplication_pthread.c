@@ -6,6 +6,7 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include "tile_scheduler.h"
 
 // Función para obtener tiempo de usuario en segundos
 double get_user_time() {
@@ -27,8 +28,7 @@ typedef struct {
     int **B;              // Matriz B
     int **C;              // Matriz resultado C
     int size;             // Tamaño de la matriz
-    int start_row;        // Fila inicial para este hilo
-    int end_row;          // Fila final para este hilo
+    ts_sched_t *sched;    // Planificador de teselas compartido
     int thread_id;        // ID del hilo
 } thread_data_t;
 
@@ -87,19 +87,25 @@ void matrix_multiply_sequential(int **A, int **B, int **C, int size) {
     }
 }
 
-// Función que ejecuta cada hilo - división por filas
+// Función que ejecuta cada hilo - teselas de C pedidas al planificador
 void* thread_matrix_multiply(void* arg) {
     thread_data_t* data = (thread_data_t*)arg;
+    int first, count;
     
-    printf("Hilo %d: procesando filas %d a %d\n", 
-           data->thread_id, data->start_row, data->end_row - 1);
+    printf("Hilo %d: iniciado\n", data->thread_id);
     
-    // Cada hilo procesa un rango de filas
-    for (int i = data->start_row; i < data->end_row; i++) {
-        for (int j = 0; j < data->size; j++) {
-            data->C[i][j] = 0;
-            for (int k = 0; k < data->size; k++) {
-                data->C[i][j] += data->A[i][k] * data->B[k][j];
+    // Cada hilo pide trozos de teselas hasta que no quedan
+    while (ts_next(data->sched, data->thread_id, &first, &count)) {
+        for (int t = first; t < first + count; t++) {
+            int i0, i1, j0, j1;
+            ts_tile_bounds(data->sched, t, &i0, &i1, &j0, &j1);
+            for (int i = i0; i < i1; i++) {
+                for (int j = j0; j < j1; j++) {
+                    data->C[i][j] = 0;
+                    for (int k = 0; k < data->size; k++) {
+                        data->C[i][j] += data->A[i][k] * data->B[k][j];
+                    }
+                }
             }
         }
     }
@@ -112,46 +118,43 @@ void* thread_matrix_multiply(void* arg) {
 void matrix_multiply_parallel(int **A, int **B, int **C, int size, int num_threads) {
     pthread_t *threads;
     thread_data_t *thread_data;
-    int rows_per_thread, remaining_rows;
+    ts_sched_t *sched;
     
-    // Allocar memoria para hilos y datos
+    // Allocar memoria para hilos, datos y planificador
     threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
     thread_data = (thread_data_t*)malloc(num_threads * sizeof(thread_data_t));
+    sched = (ts_sched_t*)malloc(ts_bytes(num_threads));
     
-    if (threads == NULL || thread_data == NULL) {
+    if (threads == NULL || thread_data == NULL || sched == NULL) {
         printf("Error: No se pudo allocar memoria para hilos\n");
         return;
     }
     
-    // Calcular distribución de trabajo
-    rows_per_thread = size / num_threads;
-    remaining_rows = size % num_threads;
-    
-    printf("Distribución: %d filas por hilo, %d filas extras\n", 
-           rows_per_thread, remaining_rows);
+    // Distribución dinámica por teselas de C
+    ts_init(sched, size, size, 0, 0, num_threads);
+    printf("Distribución: dinámica, %d teselas de %dx%d (trozos guiados)\n", 
+           sched->total_tiles, sched->tile_rows, sched->tile_cols);
     
     // Crear hilos
-    int current_row = 0;
     for (int i = 0; i < num_threads; i++) {
         thread_data[i].A = A;
         thread_data[i].B = B;
         thread_data[i].C = C;
         thread_data[i].size = size;
+        thread_data[i].sched = sched;
         thread_data[i].thread_id = i;
-        thread_data[i].start_row = current_row;
-        
-        // Distribuir filas extras entre los primeros hilos
-        int extra_row = (i < remaining_rows) ? 1 : 0;
-        thread_data[i].end_row = current_row + rows_per_thread + extra_row;
-        
-        current_row = thread_data[i].end_row;
         
         // Crear hilo
         int result = pthread_create(&threads[i], NULL, thread_matrix_multiply, &thread_data[i]);
         if (result != 0) {
             printf("Error: No se pudo crear el hilo %d\n", i);
+            // Los hilos ya creados terminan el trabajo restante
+            for (int j = 0; j < i; j++) {
+                pthread_join(threads[j], NULL);
+            }
             free(threads);
             free(thread_data);
+            free(sched);
             return;
         }
     }
@@ -160,10 +163,12 @@ void matrix_multiply_parallel(int **A, int **B, int **C, int size, int num_threa
     for (int i = 0; i < num_threads; i++) {
         pthread_join(threads[i], NULL);
     }
+    ts_report(sched, "Hilo");
     
     // Liberar memoria
     free(threads);
     free(thread_data);
+    free(sched);
 }
 
 // Función para mostrar ayuda
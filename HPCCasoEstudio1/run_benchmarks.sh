@@ -1,5 +1,5 @@
 #!/usr/bin/env bash
-# Benchmark automático de matrix_mult_all en modo CSV
+# Benchmark automático de matrix_mult_all en modo barrido (un solo proceso)
 # Genera archivo: benchmarks.csv
 
 set -euo pipefail
@@ -11,25 +11,20 @@ SIZES=(10 100 200 400 800 1600 3200)
 WORKERS=(2 4 8 12 16)
 SEED_A=123
 SEED_B=456
+# Política de afinidad: none, compact, scatter o core (queda en la columna affinity)
+AFFINITY=${AFFINITY:-none}
 
 if [[ ! -x $BIN ]]; then
   echo "Error: no se encuentra $BIN ejecutable. Compila primero." >&2
   exit 1
 fi
 
-echo "Creando encabezado CSV en $OUT" >&2
-$BIN --csv-header > "$OUT"
+join() { local IFS=,; echo "$*"; }
 
-run_id=1
-for n in "${SIZES[@]}"; do
-  for w in "${WORKERS[@]}"; do
-    echo "== Tamaño $n | Workers $w ==" >&2
-    for ((r=1; r<=REPS; r++)); do
-      # Ejecutar y añadir línea
-      $BIN "$n" "$w" $SEED_A $SEED_B --csv --run=$run_id >> "$OUT"
-      run_id=$((run_id+1))
-    done
-  done
-done
+# Un único proceso recorre tamaños x trabajadores x repeticiones reutilizando
+# la memoria del caso más grande; escribe la cabecera y las filas en orden
+echo "Barrido: tamaños $(join "${SIZES[@]}") | workers $(join "${WORKERS[@]}") | $REPS repeticiones" >&2
+$BIN --sizes="$(join "${SIZES[@]}")" --workers="$(join "${WORKERS[@]}")" --runs=$REPS \
+  $SEED_A $SEED_B --affinity="$AFFINITY" > "$OUT"
 
 echo "Benchmark completado. Archivo: $OUT" >&2
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Genera kernels de multiplicación de matrices para las seis permutaciones de
+bucles (ijk, ikj, jik, jki, kij, kji) con factores de desenrollado (unroll) del
+bucle interno y de unroll-and-jam del bucle intermedio.
+
+Salida: un .c con una función por variante y la tabla `matmul_variants[]`
+que consume src/matrix_variant_select.c.
+
+Uso: python3 scripts/genera_variantes.py [--unroll 1,4] [--jam 1,2] [-o archivo]
+"""
+
+import argparse
+import itertools
+
+STMT = "C[{i}][{j}] += A[{i}][{k}] * B[{k}][{j}];"
+
+
+def stmt(order, outer, middle, inner):
+    # Asigna las expresiones de cada nivel a i, j, k según el orden
+    names = dict(zip(order, (outer, middle, inner)))
+    return STMT.format(i=names["i"], j=names["j"], k=names["k"])
+
+
+def kernel(order, unroll, jam):
+    o, m, x = order
+    name = f"matmul_{order}_u{unroll}_j{jam}"
+    lines = [
+        f"// Orden {order[0]}-{order[1]}-{order[2]}, unroll {unroll} (bucle {x}), jam {jam} (bucle {m})",
+        f"static void {name}(int **A, int **B, int **C, int n) {{",
+        "    for (int r = 0; r < n; r++) memset(C[r], 0, n * sizeof(int));",
+        f"    for (int {o} = 0; {o} < n; {o}++) {{",
+        f"        int {m} = 0;",
+        f"        for (; {m} + {jam} <= n; {m} += {jam}) {{",
+        f"            int {x} = 0;",
+        f"            for (; {x} + {unroll} <= n; {x} += {unroll}) {{",
+    ]
+    for jm in range(jam):
+        for u in range(unroll):
+            mid = m if jm == 0 else f"{m} + {jm}"
+            inn = x if u == 0 else f"{x} + {u}"
+            lines.append("                " + stmt(order, o, f"({mid})", f"({inn})"))
+    lines.append("            }")
+    lines.append(f"            for (; {x} < n; {x}++) {{")
+    for jm in range(jam):
+        mid = m if jm == 0 else f"{m} + {jm}"
+        lines.append("                " + stmt(order, o, f"({mid})", x))
+    lines += [
+        "            }",
+        "        }",
+        f"        for (; {m} < n; {m}++) {{",
+        f"            for (int {x} = 0; {x} < n; {x}++) {{",
+        "                " + stmt(order, o, m, x),
+        "            }",
+        "        }",
+        "    }",
+        "}",
+        "",
+    ]
+    return name, "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--unroll", default="1,4", help="factores de unroll del bucle interno")
+    parser.add_argument("--jam", default="1,2", help="factores de unroll-and-jam del bucle intermedio")
+    parser.add_argument("-o", "--output", default="src/matmul_variants_gen.c")
+    args = parser.parse_args()
+
+    unrolls = [int(u) for u in args.unroll.split(",")]
+    jams = [int(j) for j in args.jam.split(",")]
+    orders = ["".join(p) for p in itertools.permutations("ijk")]
+
+    out = [
+        "// ARCHIVO GENERADO por scripts/genera_variantes.py - no editar a mano",
+        f"// unroll={args.unroll} jam={args.jam}",
+        "#include <string.h>",
+        "",
+    ]
+    table = []
+    for order, unroll, jam in itertools.product(orders, unrolls, jams):
+        name, code = kernel(order, unroll, jam)
+        out.append(code)
+        table.append(f'    {{"{order}_u{unroll}_j{jam}", {name}}},')
+
+    out += [
+        "typedef void (*matmul_kernel_t)(int **A, int **B, int **C, int n);",
+        "",
+        "typedef struct {",
+        "    const char *name;",
+        "    matmul_kernel_t fn;",
+        "} matmul_variant_t;",
+        "",
+        "static const matmul_variant_t matmul_variants[] = {",
+        *table,
+        "};",
+        "",
+        "#define NUM_MATMUL_VARIANTS (int)(sizeof(matmul_variants) / sizeof(matmul_variants[0]))",
+        "",
+    ]
+    with open(args.output, "w") as f:
+        f.write("\n".join(out))
+    print(f"{len(table)} variantes escritas en {args.output}")
+
+
+if __name__ == "__main__":
+    main()
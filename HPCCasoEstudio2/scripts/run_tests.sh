@@ -5,6 +5,8 @@ RESULTS_FILE="results.csv"
 MATRIX_SIZES=(100 200 400 800 1600 3200)
 REPEATS=5
 THREADS=8
+SEED_A=12345
+SEED_B=54321
 
 
 # Encabezado del archivo CSV
@@ -34,22 +36,18 @@ run_version() {
 
 
 for size in "${MATRIX_SIZES[@]}"; do
-    echo "Ejecutando secuencial para tamaño $size..."
-    seq_total=0
-    for ((i=1; i<=REPEATS; i++)); do
-        wall_time=$(./$BIN_DIR/matrix_multiplication_sequential $size | grep "Tiempo real" | awk '{print $5}')
-        seq_total=$(echo "$seq_total + $wall_time" | bc -l)
-        echo "secuencial,$size,$wall_time,1" >> $RESULTS_FILE
-    done
-    seq_avg=$(echo "$seq_total / $REPEATS" | bc -l)
+    # La referencia secuencial sale de la caché en disco (se calcula solo la primera vez)
+    echo "Obteniendo referencia secuencial para tamaño $size..."
+    seq_avg=$(./$BIN_DIR/reference_cache $size $SEED_A $SEED_B $REPEATS | grep "Tiempo real" | awk '{print $5}')
+    echo "secuencial,$size,$seq_avg,1" >> $RESULTS_FILE
 
-    for version in "optimized" "parallel" "blocking" "seq_omp" "blocking_seq"; do
+    for version in "optimized" "parallel" "blocking" "seq_omp" "blocking_seq" "morton"; do
         echo "Ejecutando $version para tamaño $size..."
         for ((i=1; i<=REPEATS; i++)); do
             if [ "$version" == "parallel" ]; then
                 export OMP_NUM_THREADS=$THREADS
             fi
-            wall_time=$(./$BIN_DIR/matrix_multiplication_$version $size | grep "Tiempo real" | awk '{print $5}')
+            wall_time=$(./$BIN_DIR/matrix_multiplication_$version $size $SEED_A $SEED_B | grep "Tiempo real" | awk '{print $5}')
             speedup=$(echo "$seq_avg / $wall_time" | bc -l)
             echo "$version,$size,$wall_time,$speedup" >> $RESULTS_FILE
         done
@@ -21,10 +21,10 @@ get_sum() {
 
 for size in "${MATRIX_SIZES[@]}"; do
     echo "Verificando tamaño de matriz $size..."
-    # Ejecutar secuencial y guardar suma
-    sum_ref=$(./$BIN_DIR/matrix_multiplication_sequential $size $SEED_A $SEED_B | grep "Suma de verificación" | awk -F":" '{print $2}' | tr -d ' ')
+    # Suma de referencia desde la caché en disco (calcula el secuencial solo si falta)
+    sum_ref=$(./$BIN_DIR/reference_cache $size $SEED_A $SEED_B | grep "Suma de verificación" | awk -F":" '{print $2}' | tr -d ' ')
     echo "Secuencial: $sum_ref"
-    for version in optimized parallel blocking seq_omp blocking_seq; do
+    for version in optimized parallel blocking seq_omp blocking_seq int64 morton; do
         for ((i=1; i<=REPEATS; i++)); do
             sum=$(get_sum $version $size $THREADS)
             if [ "$sum" == "$sum_ref" ]; then
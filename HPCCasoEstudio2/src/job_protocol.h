@@ -0,0 +1,153 @@
+/*
+ * job_protocol.h - Protocolo del servidor de multiplicaciones (matrix_server)
+ *
+ * Mensajes binarios en orden de bytes del host sobre un socket Unix (mismo equipo).
+ * Una conexión puede enviar varias peticiones seguidas; cada una recibe una respuesta.
+ *
+ *   petición:  job_request_t [+ A (m*k int32) + B (k*n int32) si source == JOB_SRC_INLINE]
+ *   respuesta: job_response_t [+ C (m*n int32) si reply == JOB_REPLY_MATRIX y status == 0]
+ *              o job_stats_t para JOB_OP_STATS
+ *
+ * Las matrices son row-major contiguas. Con JOB_SRC_FILES el servidor lee A y B
+ * de archivos binarios int32 row-major; con JOB_SRC_SEEDS las genera con
+ * srand(semilla) / rand() % 100 como el resto de los programas.
+ */
+#ifndef JOB_PROTOCOL_H
+#define JOB_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define JOB_MAGIC 0x4d4d4a42u            // "MMJB"
+#define JOB_DEFAULT_SOCKET "/tmp/hpc_matmul.sock"
+#define JOB_PATH_MAX 256
+#define JOB_MAX_DIM 8192
+#define JOB_LATENCY_BUCKETS 32           // Histograma log2 en microsegundos
+
+enum { JOB_OP_MULTIPLY = 1, JOB_OP_STATS = 2, JOB_OP_SHUTDOWN = 3 };
+enum { JOB_SRC_INLINE = 0, JOB_SRC_FILES = 1, JOB_SRC_SEEDS = 2 };
+enum { JOB_REPLY_CHECKSUM = 0, JOB_REPLY_MATRIX = 1 };
+enum { JOB_OK = 0, JOB_ERR_PROTOCOL = 1, JOB_ERR_SHAPE = 2, JOB_ERR_FILE = 3, JOB_ERR_MEMORY = 4 };
+
+typedef struct {
+    uint32_t magic;
+    uint32_t op;
+    uint32_t m, k, n;                    // A es m x k, B es k x n
+    uint32_t source;
+    uint32_t reply;
+    int32_t seed_a, seed_b;
+    char path_a[JOB_PATH_MAX];
+    char path_b[JOB_PATH_MAX];
+} job_request_t;
+
+typedef struct {
+    uint32_t magic;
+    int32_t status;
+    uint32_t m, n;
+    int64_t checksum;
+    uint32_t batch_size;                 // Trabajos ejecutados en el mismo lote
+    uint32_t workers;                    // Hilos que participaron en el cálculo
+    double queue_wait;                   // Segundos en cola antes de empezar
+    double compute_time;                 // Segundos de cálculo
+    double server_time;                  // Desde que se leyó la petición hasta la respuesta
+} job_response_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t workers;
+    uint64_t jobs;
+    uint64_t batches;                    // Lotes de trabajos pequeños
+    uint64_t batched_jobs;               // Trabajos que corrieron dentro de un lote
+    uint64_t split_jobs;                 // Trabajos grandes repartidos entre hilos
+    uint64_t errors;
+    uint64_t arena_hits;
+    uint64_t arena_misses;
+    uint64_t arena_bytes;                // Bytes retenidos por la arena
+    double uptime;
+    double flops;                        // 2*m*k*n acumulado
+    double latency_sum;
+    double latency_max;
+    uint64_t latency_hist[JOB_LATENCY_BUCKETS];
+} job_stats_t;
+
+// Lee exactamente len bytes; 0 si la conexión se cerró o hubo error
+static inline int job_read_full(int fd, void *buf, size_t len) {
+    char *p = (char*)buf;
+    while (len > 0) {
+        ssize_t r = read(fd, p, len);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return 0;
+        p += r;
+        len -= (size_t)r;
+    }
+    return 1;
+}
+
+// Escribe exactamente len bytes; 0 si hubo error
+static inline int job_write_full(int fd, const void *buf, size_t len) {
+    const char *p = (const char*)buf;
+    while (len > 0) {
+        ssize_t w = write(fd, p, len);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return 0;
+        p += w;
+        len -= (size_t)w;
+    }
+    return 1;
+}
+
+// Percentil (0-100) aproximado del histograma log2: devuelve el límite superior
+// del bucket en segundos
+static inline double job_latency_percentile(const job_stats_t *s, double pct) {
+    uint64_t total = 0, acc = 0;
+    for (int b = 0; b < JOB_LATENCY_BUCKETS; b++) total += s->latency_hist[b];
+    if (total == 0) return 0.0;
+    for (int b = 0; b < JOB_LATENCY_BUCKETS; b++) {
+        acc += s->latency_hist[b];
+        if ((double)acc >= pct / 100.0 * (double)total) return (double)(1ULL << b) * 1e-6;
+    }
+    return (double)(1ULL << (JOB_LATENCY_BUCKETS - 1)) * 1e-6;
+}
+
+// Bucket de una latencia en segundos: el primer b con latencia <= 2^b µs
+static inline int job_latency_bucket(double seconds) {
+    double us = seconds * 1e6;
+    int b = 0;
+    while (b < JOB_LATENCY_BUCKETS - 1 && (double)(1ULL << b) < us) b++;
+    return b;
+}
+
+// Ruta del socket: $MATMUL_SOCKET o JOB_DEFAULT_SOCKET
+static inline const char* job_socket_path(void) {
+    const char *path = getenv("MATMUL_SOCKET");
+    return (path != NULL && path[0] != '\0') ? path : JOB_DEFAULT_SOCKET;
+}
+
+// Conecta al servidor; devuelve el descriptor o -1
+static inline int job_connect(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static inline void job_request_init(job_request_t *req, uint32_t op) {
+    memset(req, 0, sizeof(*req));
+    req->magic = JOB_MAGIC;
+    req->op = op;
+}
+
+#endif
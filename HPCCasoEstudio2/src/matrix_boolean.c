@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// Bloque de k: 256 filas de B
+#define K_BLOCK 256
+// Bloque de palabras de C/B: 64 palabras = 4096 columnas. El trozo de B de un
+// bloque (k, palabras) ocupa como mucho 256 * 64 * 8 = 128 KB, para L2
+#define W_BLOCK 64
+// Bloque de filas de A/C: todas recorren el mismo trozo de B antes de pasar al siguiente
+#define I_BLOCK 32
+// Bloque de filas/columnas para el conteo de caminos con popcount
+#define COUNT_BLOCK 64
+#define VERIFY_ROWS 64
+
+typedef enum { MODE_PRODUCT, MODE_COUNT, MODE_CLOSURE } bool_mode_t;
+
+// Matriz booleana n x n empaquetada por filas: el bit j de la fila i está en
+// bits[i * words + j / 64], posición j % 64. Los bits de relleno valen 0.
+typedef struct {
+    uint64_t *bits;
+    int n;
+    int words;
+} bitmat_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+int bitmat_alloc(bitmat_t *m, int n) {
+    m->n = n;
+    m->words = (n + 63) / 64;
+    m->bits = (uint64_t*)aligned_alloc(64, ((size_t)n * m->words * sizeof(uint64_t) + 63) & ~(size_t)63);
+    if (m->bits == NULL) return 0;
+    memset(m->bits, 0, (size_t)n * m->words * sizeof(uint64_t));
+    return 1;
+}
+
+void bitmat_free(bitmat_t *m) {
+    free(m->bits);
+    m->bits = NULL;
+}
+
+static inline uint64_t* bitmat_row(const bitmat_t *m, int i) {
+    return &m->bits[(size_t)i * m->words];
+}
+
+static inline int bitmat_get(const bitmat_t *m, int i, int j) {
+    return (int)((bitmat_row(m, i)[j >> 6] >> (j & 63)) & 1);
+}
+
+static inline void bitmat_set(bitmat_t *m, int i, int j) {
+    bitmat_row(m, i)[j >> 6] |= 1ULL << (j & 63);
+}
+
+// Mismo esquema que initialize_matrix (srand(semilla), un rand() por elemento) pero
+// umbralizado: el elemento es 1 con probabilidad `densidad`. Se compara contra
+// RAND_MAX y no contra rand() % 100 para admitir densidades menores a 1%.
+void initialize_bool_matrix(bitmat_t *m, int seed, double density) {
+    double threshold = density * ((double)RAND_MAX + 1.0);
+    srand(seed);
+    for (int i = 0; i < m->n; i++) {
+        for (int j = 0; j < m->n; j++) {
+            if ((double)rand() < threshold) bitmat_set(m, i, j);
+        }
+    }
+}
+
+long long bitmat_popcount(const bitmat_t *m) {
+    long long total = 0;
+    for (size_t w = 0; w < (size_t)m->n * m->words; w++) {
+        total += __builtin_popcountll(m->bits[w]);
+    }
+    return total;
+}
+
+// C = A · B sobre (OR, AND): la fila i de C es el OR de las filas k de B con
+// A[i][k] = 1. Se recorren solo los bits encendidos de A (ctz). Cada hilo toma un
+// bloque de I_BLOCK filas y, por cada trozo de B (K_BLOCK filas x W_BLOCK
+// palabras), pasa todas sus filas antes de cambiar de trozo: el trozo se lee de
+// memoria una vez por bloque de filas y no una vez por fila.
+void bool_multiply(const bitmat_t *A, const bitmat_t *B, bitmat_t *C) {
+    int n = A->n, words = A->words;
+    memset(C->bits, 0, (size_t)n * words * sizeof(uint64_t));
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int ii = 0; ii < n; ii += I_BLOCK) {
+        int i_end = (ii + I_BLOCK < n) ? ii + I_BLOCK : n;
+        for (int kk = 0; kk < n; kk += K_BLOCK) {
+            int kw_begin = kk >> 6;
+            int kw_end = ((kk + K_BLOCK < n ? kk + K_BLOCK : n) + 63) >> 6;
+            for (int ww = 0; ww < words; ww += W_BLOCK) {
+                int w_end = (ww + W_BLOCK < words) ? ww + W_BLOCK : words;
+                for (int i = ii; i < i_end; i++) {
+                    const uint64_t *a_row = bitmat_row(A, i);
+                    uint64_t *c_row = bitmat_row(C, i);
+                    for (int kw = kw_begin; kw < kw_end; kw++) {
+                        uint64_t mask = a_row[kw];
+                        while (mask) {
+                            int k = (kw << 6) + __builtin_ctzll(mask);
+                            const uint64_t *b_row = bitmat_row(B, k);
+                            for (int w = ww; w < w_end; w++) {
+                                c_row[w] |= b_row[w];
+                            }
+                            mask &= mask - 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void bitmat_transpose(const bitmat_t *src, bitmat_t *dst) {
+    memset(dst->bits, 0, (size_t)dst->n * dst->words * sizeof(uint64_t));
+    for (int i = 0; i < src->n; i++) {
+        const uint64_t *row = bitmat_row(src, i);
+        for (int w = 0; w < src->words; w++) {
+            uint64_t mask = row[w];
+            while (mask) {
+                int j = (w << 6) + __builtin_ctzll(mask);
+                bitmat_set(dst, j, i);
+                mask &= mask - 1;
+            }
+        }
+    }
+}
+
+// P[i][j] = número de k con A[i][k] = B[k][j] = 1 (caminos de longitud 2 vía k):
+// popcount(fila i de A AND fila j de Bᵀ). Bloques de COUNT_BLOCK filas de Bᵀ.
+void bool_count_paths(const bitmat_t *A, const bitmat_t *BT, int **P) {
+    int n = A->n, words = A->words;
+
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int ii = 0; ii < n; ii += COUNT_BLOCK) {
+        for (int jj = 0; jj < n; jj += COUNT_BLOCK) {
+            int i_end = (ii + COUNT_BLOCK < n) ? ii + COUNT_BLOCK : n;
+            int j_end = (jj + COUNT_BLOCK < n) ? jj + COUNT_BLOCK : n;
+            for (int i = ii; i < i_end; i++) {
+                const uint64_t *a_row = bitmat_row(A, i);
+                for (int j = jj; j < j_end; j++) {
+                    const uint64_t *bt_row = bitmat_row(BT, j);
+                    int count = 0;
+                    for (int w = 0; w < words; w++) {
+                        count += __builtin_popcountll(a_row[w] & bt_row[w]);
+                    }
+                    P[i][j] = count;
+                }
+            }
+        }
+    }
+}
+
+// Cierre reflexivo-transitivo por cuadrados sucesivos: R = A ∪ I y R = R · R
+// hasta que no cambie (a lo sumo ceil(log2 n) cuadrados). Devuelve los cuadrados hechos.
+int bool_closure(const bitmat_t *A, bitmat_t *R) {
+    int n = A->n;
+    bitmat_t tmp;
+    if (!bitmat_alloc(&tmp, n)) return -1;
+
+    memcpy(R->bits, A->bits, (size_t)n * A->words * sizeof(uint64_t));
+    for (int i = 0; i < n; i++) bitmat_set(R, i, i);
+
+    int squarings = 0;
+    for (;;) {
+        bool_multiply(R, R, &tmp);
+        squarings++;
+        int changed = memcmp(tmp.bits, R->bits, (size_t)n * R->words * sizeof(uint64_t)) != 0;
+        uint64_t *swap = R->bits;
+        R->bits = tmp.bits;
+        tmp.bits = swap;
+        if (!changed) break;
+    }
+
+    bitmat_free(&tmp);
+    return squarings;
+}
+
+// Verificación del producto: filas muestreadas con el producto entero sobre 0/1
+int verify_product(const bitmat_t *A, const bitmat_t *B, const bitmat_t *C, int **P, bool_mode_t mode) {
+    int n = A->n;
+    int *row = (int*)malloc(n * sizeof(int));
+    int rows = (n < VERIFY_ROWS) ? n : VERIFY_ROWS;
+    int ok = 1;
+    for (int r = 0; r < rows && ok; r++) {
+        int i = (int)(((long long)r * n) / rows);
+        memset(row, 0, n * sizeof(int));
+        for (int k = 0; k < n; k++) {
+            if (!bitmat_get(A, i, k)) continue;
+            for (int j = 0; j < n; j++) {
+                row[j] += bitmat_get(B, k, j);
+            }
+        }
+        for (int j = 0; j < n; j++) {
+            int expected = (mode == MODE_COUNT) ? row[j] : (row[j] > 0);
+            int got = (mode == MODE_COUNT) ? P[i][j] : bitmat_get(C, i, j);
+            if (expected != got) {
+                printf("✗ Error en (%d, %d): %d (esperado %d)\n", i, j, got, expected);
+                ok = 0;
+                break;
+            }
+        }
+    }
+    free(row);
+    return ok;
+}
+
+// Verificación del cierre con Warshall sobre bits (algoritmo independiente)
+int verify_closure(const bitmat_t *A, const bitmat_t *R) {
+    int n = A->n;
+    bitmat_t W;
+    if (!bitmat_alloc(&W, n)) return 0;
+    memcpy(W.bits, A->bits, (size_t)n * A->words * sizeof(uint64_t));
+    for (int i = 0; i < n; i++) bitmat_set(&W, i, i);
+    for (int k = 0; k < n; k++) {
+        const uint64_t *k_row = bitmat_row(&W, k);
+        for (int i = 0; i < n; i++) {
+            if (!bitmat_get(&W, i, k)) continue;
+            uint64_t *i_row = bitmat_row(&W, i);
+            for (int w = 0; w < W.words; w++) i_row[w] |= k_row[w];
+        }
+    }
+    int ok = memcmp(W.bits, R->bits, (size_t)n * W.words * sizeof(uint64_t)) == 0;
+    if (!ok) printf("✗ Error: el cierre no coincide con Warshall\n");
+    bitmat_free(&W);
+    return ok;
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [densidad] [modo] [semilla_A] [semilla_B]\n", program_name);
+    printf("  tamaño_matriz: Tamaño de las matrices booleanas cuadradas (obligatorio)\n");
+    printf("  densidad: Fracción de unos en [0, 1] (opcional, por defecto: 0.05)\n");
+    printf("  modo: producto (OR, AND), caminos (conteo con popcount) o cierre\n");
+    printf("        (cierre transitivo de A por cuadrados sucesivos) (opcional, por defecto: producto)\n");
+    printf("  semilla_A: Semilla para generar matriz A (opcional, por defecto: tiempo actual)\n");
+    printf("  semilla_B: Semilla para generar matriz B (opcional, por defecto: tiempo actual + 1)\n");
+    printf("\nEjemplo: %s 4096 0.01 cierre 123\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int seed_A, seed_B;
+    double density = 0.05;
+    bool_mode_t mode = MODE_PRODUCT;
+    double start_time, end_time, wall_start, wall_end;
+
+    if (argc < 2 || argc > 6) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    if (argc >= 3) density = atof(argv[2]);
+    if (density < 0.0 || density > 1.0) {
+        printf("Error: La densidad debe estar en [0, 1].\n");
+        return 1;
+    }
+    if (argc >= 4) {
+        if (strcmp(argv[3], "producto") == 0) mode = MODE_PRODUCT;
+        else if (strcmp(argv[3], "caminos") == 0) mode = MODE_COUNT;
+        else if (strcmp(argv[3], "cierre") == 0) mode = MODE_CLOSURE;
+        else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    seed_A = (argc >= 5) ? atoi(argv[4]) : (int)time(NULL);
+    seed_B = (argc == 6) ? atoi(argv[5]) : seed_A + 1;
+
+    bitmat_t A, B, C;
+    if (!bitmat_alloc(&A, size) || !bitmat_alloc(&B, size) || !bitmat_alloc(&C, size)) {
+        printf("Error: No se pudo alocar memoria para las matrices.\n");
+        return 1;
+    }
+    initialize_bool_matrix(&A, seed_A, density);
+    initialize_bool_matrix(&B, seed_B, density);
+
+    size_t packed_bytes = (size_t)size * A.words * sizeof(uint64_t);
+    printf("Memoria por matriz: %.2f MB empaquetada vs %.2f MB como int32\n",
+           packed_bytes / 1048576.0, (double)size * size * sizeof(int) / 1048576.0);
+
+    int **P = NULL;
+    bitmat_t BT;
+    long long result_sum = 0;
+    int squarings = 0;
+    int correct;
+
+    start_time = get_user_time();
+    wall_start = get_wall_time();
+    if (mode == MODE_PRODUCT) {
+        bool_multiply(&A, &B, &C);
+    } else if (mode == MODE_COUNT) {
+        P = allocate_matrix(size);
+        if (!bitmat_alloc(&BT, size)) {
+            printf("Error: No se pudo alocar memoria para Bᵀ.\n");
+            return 1;
+        }
+        bitmat_transpose(&B, &BT);
+        bool_count_paths(&A, &BT, P);
+    } else {
+        squarings = bool_closure(&A, &C);
+    }
+    end_time = get_user_time();
+    wall_end = get_wall_time();
+
+    if (mode == MODE_COUNT) {
+        for (int i = 0; i < size; i++) {
+            for (int j = 0; j < size; j++) result_sum += P[i][j];
+        }
+        correct = verify_product(&A, &B, NULL, P, mode);
+        bitmat_free(&BT);
+    } else if (mode == MODE_PRODUCT) {
+        result_sum = bitmat_popcount(&C);
+        correct = verify_product(&A, &B, &C, NULL, mode);
+    } else {
+        result_sum = bitmat_popcount(&C);
+        printf("Cuadrados realizados: %d\n", squarings);
+        printf("Pares alcanzables: %lld de %lld (%.2f%%)\n", result_sum,
+               (long long)size * size, 100.0 * result_sum / ((double)size * size));
+        correct = (squarings > 0) && verify_closure(&A, &C);
+    }
+    if (correct) {
+        printf("✓ Verificación exitosa: el resultado coincide con la referencia\n");
+    }
+
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+    printf("Suma de verificación de la matriz resultado: %lld\n", result_sum);
+
+    if (P != NULL) free_matrix(P, size);
+    bitmat_free(&A);
+    bitmat_free(&B);
+    bitmat_free(&C);
+
+    return correct ? 0 : 1;
+}
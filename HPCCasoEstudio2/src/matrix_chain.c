@@ -0,0 +1,338 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <math.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <omp.h>
+
+#define BLOCK_SIZE 32
+#define MAX_CHAIN 64
+
+// Nodo del árbol de expresión: hoja (i == j) o producto de dos subárboles
+typedef struct chain_node {
+    int i, j;                  // Rango de matrices [i, j] de la cadena
+    int rows, cols;            // Dimensiones del resultado
+    struct chain_node *left;
+    struct chain_node *right;
+    double **result;           // Resultado (en hojas apunta a la matriz de entrada)
+} chain_node_t;
+
+// Contador de FLOPs realmente ejecutados (2*m*k*n por producto)
+static long long flops_executed = 0;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para allocar memoria para una matriz rectangular
+double** allocate_matrix(int rows, int cols) {
+    double **matrix = (double**)malloc(rows * sizeof(double*));
+    if (matrix == NULL) return NULL;
+    for (int i = 0; i < rows; i++) {
+        matrix[i] = (double*)malloc(cols * sizeof(double));
+        if (matrix[i] == NULL) {
+            for (int j = 0; j < i; j++) free(matrix[j]);
+            free(matrix);
+            return NULL;
+        }
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(double **matrix, int rows) {
+    for (int i = 0; i < rows; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// Función para inicializar una matriz rectangular con valores aleatorios
+void initialize_matrix(double **matrix, int rows, int cols, int seed) {
+    srand(seed);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            matrix[i][j] = (double)(rand() % 100);
+        }
+    }
+}
+
+// GEMM rectangular con blocking: C(m x n) = A(m x k) * B(k x n)
+// Los bloques de filas se reparten como tareas (taskloop), de modo que
+// se compone con las tareas del árbol de la cadena sin anidar regiones paralelas.
+void matrix_multiply_rect(double **A, double **B, double **C, int m, int k, int n) {
+    #pragma omp taskloop grainsize(1)
+    for (int ii = 0; ii < m; ii += BLOCK_SIZE) {
+        int i_end = (ii + BLOCK_SIZE < m) ? ii + BLOCK_SIZE : m;
+        for (int i = ii; i < i_end; i++) {
+            memset(C[i], 0, n * sizeof(double));
+        }
+        for (int kk = 0; kk < k; kk += BLOCK_SIZE) {
+            int k_end = (kk + BLOCK_SIZE < k) ? kk + BLOCK_SIZE : k;
+            for (int jj = 0; jj < n; jj += BLOCK_SIZE) {
+                int j_end = (jj + BLOCK_SIZE < n) ? jj + BLOCK_SIZE : n;
+                for (int i = ii; i < i_end; i++) {
+                    double *c_row = C[i];
+                    for (int p = kk; p < k_end; p++) {
+                        double a = A[i][p];
+                        double *b_row = B[p];
+                        for (int j = jj; j < j_end; j++) {
+                            c_row[j] += a * b_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    #pragma omp atomic
+    flops_executed += 2LL * m * k * n;
+}
+
+// Programación dinámica O(n³) para la parentización óptima.
+// cost[i][j] = mínimo de multiplicaciones escalares para A_i..A_j,
+// split[i][j] = k donde conviene partir (A_i..A_k)(A_k+1..A_j).
+long long matrix_chain_order(const int *dims, int count,
+                             long long cost[MAX_CHAIN][MAX_CHAIN],
+                             int split[MAX_CHAIN][MAX_CHAIN]) {
+    for (int i = 0; i < count; i++) {
+        cost[i][i] = 0;
+    }
+    for (int len = 2; len <= count; len++) {
+        for (int i = 0; i + len - 1 < count; i++) {
+            int j = i + len - 1;
+            cost[i][j] = -1;
+            for (int k = i; k < j; k++) {
+                long long q = cost[i][k] + cost[k + 1][j]
+                            + (long long)dims[i] * dims[k + 1] * dims[j + 1];
+                if (cost[i][j] < 0 || q < cost[i][j]) {
+                    cost[i][j] = q;
+                    split[i][j] = k;
+                }
+            }
+        }
+    }
+    return cost[0][count - 1];
+}
+
+// Construye el árbol de expresión a partir de la tabla de cortes
+chain_node_t* build_chain_tree(int split[MAX_CHAIN][MAX_CHAIN], const int *dims,
+                               double ***inputs, int i, int j) {
+    chain_node_t *node = (chain_node_t*)calloc(1, sizeof(chain_node_t));
+    node->i = i;
+    node->j = j;
+    node->rows = dims[i];
+    node->cols = dims[j + 1];
+    if (i == j) {
+        node->result = inputs[i];
+    } else {
+        node->left = build_chain_tree(split, dims, inputs, i, split[i][j]);
+        node->right = build_chain_tree(split, dims, inputs, split[i][j] + 1, j);
+    }
+    return node;
+}
+
+// Imprime la parentización, p.ej. ((A0 A1) A2)
+void print_chain_tree(chain_node_t *node) {
+    if (node->left == NULL) {
+        printf("A%d", node->i);
+        return;
+    }
+    printf("(");
+    print_chain_tree(node->left);
+    printf(" ");
+    print_chain_tree(node->right);
+    printf(")");
+}
+
+// Evalúa el árbol: los subproductos independientes se lanzan como tareas
+void evaluate_chain_tree(chain_node_t *node) {
+    if (node->left == NULL) return;
+
+    #pragma omp task if(node->left->left != NULL)
+    evaluate_chain_tree(node->left);
+    #pragma omp task if(node->right->left != NULL)
+    evaluate_chain_tree(node->right);
+    #pragma omp taskwait
+
+    node->result = allocate_matrix(node->rows, node->cols);
+    matrix_multiply_rect(node->left->result, node->right->result, node->result,
+                         node->left->rows, node->left->cols, node->right->cols);
+}
+
+// Libera los resultados intermedios y los nodos (las hojas no son dueñas de su matriz)
+void free_chain_tree(chain_node_t *node) {
+    if (node->left != NULL) {
+        free_chain_tree(node->left);
+        free_chain_tree(node->right);
+        free_matrix(node->result, node->rows);
+    }
+    free(node);
+}
+
+// Referencia: evaluación de izquierda a derecha ((A0 A1) A2) ...
+double** multiply_left_to_right(double ***inputs, const int *dims, int count) {
+    double **acc = allocate_matrix(dims[0], dims[1]);
+    for (int i = 0; i < dims[0]; i++) {
+        memcpy(acc[i], inputs[0][i], dims[1] * sizeof(double));
+    }
+    for (int m = 1; m < count; m++) {
+        double **next = allocate_matrix(dims[0], dims[m + 1]);
+        #pragma omp parallel
+        #pragma omp single
+        matrix_multiply_rect(acc, inputs[m], next, dims[0], dims[m], dims[m + 1]);
+        free_matrix(acc, dims[0]);
+        acc = next;
+    }
+    return acc;
+}
+
+// Costo (en multiplicaciones escalares) del orden de izquierda a derecha
+long long left_to_right_cost(const int *dims, int count) {
+    long long total = 0;
+    for (int m = 1; m < count; m++) {
+        total += (long long)dims[0] * dims[m] * dims[m + 1];
+    }
+    return total;
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <d0,d1,...,dn> [semilla]\n", program_name);
+    printf("  d0..dn: Dimensiones de la cadena, la matriz Ai es d(i) x d(i+1) (obligatorio)\n");
+    printf("  semilla: Semilla base; la matriz Ai usa semilla + i (opcional, por defecto: tiempo actual)\n");
+    printf("\nEjemplo: %s 30,350,15,500,10,200,25 123\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int dims[MAX_CHAIN + 1];
+    int count = 0;
+    int seed;
+    static long long cost[MAX_CHAIN][MAX_CHAIN];
+    static int split[MAX_CHAIN][MAX_CHAIN];
+
+    if (argc < 2 || argc > 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Leer la lista de dimensiones separadas por comas
+    char *dims_arg = strdup(argv[1]);
+    if (dims_arg == NULL) {
+        printf("Error: No se pudo alocar memoria para los argumentos.\n");
+        return 1;
+    }
+    int num_dims = 0;
+    for (char *tok = strtok(dims_arg, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        if (num_dims > MAX_CHAIN) {
+            printf("Error: La cadena admite como máximo %d matrices.\n", MAX_CHAIN);
+            free(dims_arg);
+            return 1;
+        }
+        dims[num_dims] = atoi(tok);
+        if (dims[num_dims] <= 0) {
+            printf("Error: Las dimensiones deben ser números positivos.\n");
+            free(dims_arg);
+            return 1;
+        }
+        num_dims++;
+    }
+    free(dims_arg);
+    count = num_dims - 1;
+    if (count < 2) {
+        printf("Error: Se necesitan al menos 3 dimensiones (2 matrices).\n");
+        return 1;
+    }
+
+    seed = (argc == 3) ? atoi(argv[2]) : (int)time(NULL);
+
+    // Matrices de entrada
+    double ***inputs = (double***)malloc(count * sizeof(double**));
+    for (int m = 0; m < count; m++) {
+        inputs[m] = allocate_matrix(dims[m], dims[m + 1]);
+        if (inputs[m] == NULL) {
+            printf("Error: No se pudo alocar memoria para las matrices.\n");
+            return 1;
+        }
+        initialize_matrix(inputs[m], dims[m], dims[m + 1], seed + m);
+    }
+
+    // Parentización óptima
+    long long optimal_mults = matrix_chain_order(dims, count, cost, split);
+    long long naive_mults = left_to_right_cost(dims, count);
+    chain_node_t *root = build_chain_tree(split, dims, inputs, 0, count - 1);
+
+    printf("Cadena de %d matrices, resultado %d x %d\n", count, dims[0], dims[count]);
+    printf("Parentización óptima: ");
+    print_chain_tree(root);
+    printf("\n");
+
+    // Ejecución óptima con tareas OpenMP
+    flops_executed = 0;
+    double start_time = get_user_time();
+    double wall_start = get_wall_time();
+    #pragma omp parallel
+    #pragma omp single
+    evaluate_chain_tree(root);
+    double wall_end = get_wall_time();
+    double end_time = get_user_time();
+    long long optimal_flops = flops_executed;
+    double wall_time_used = wall_end - wall_start;
+
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_time_used);
+    printf("FLOPs predichos (óptimo): %lld\n", 2 * optimal_mults);
+    printf("FLOPs ejecutados (óptimo): %lld\n", optimal_flops);
+    printf("GFLOPS (wall): %.6f\n", optimal_flops / (wall_time_used * 1e9));
+
+    // Referencia de izquierda a derecha para comparar costo y resultado
+    flops_executed = 0;
+    double naive_start = get_wall_time();
+    double **reference = multiply_left_to_right(inputs, dims, count);
+    double naive_wall = get_wall_time() - naive_start;
+
+    printf("FLOPs predichos (izquierda a derecha): %lld\n", 2 * naive_mults);
+    printf("FLOPs ejecutados (izquierda a derecha): %lld\n", flops_executed);
+    printf("Tiempo real izquierda a derecha: %.6f segundos\n", naive_wall);
+    printf("Ahorro de FLOPs: %.2fx\n", (double)naive_mults / (double)optimal_mults);
+
+    // Verificación con tolerancia relativa (el orden cambia el redondeo)
+    int correct = 1;
+    double sum = 0.0;
+    for (int i = 0; i < dims[0] && correct; i++) {
+        for (int j = 0; j < dims[count]; j++) {
+            double expected = reference[i][j];
+            double diff = fabs(root->result[i][j] - expected);
+            if (diff > 1e-9 * fabs(expected) + 1e-9) {
+                printf("✗ Error: C[%d][%d]=%.6e != %.6e\n", i, j, root->result[i][j], expected);
+                correct = 0;
+                break;
+            }
+            sum += root->result[i][j];
+        }
+    }
+    if (correct) {
+        printf("✓ Verificación exitosa: coincide con la evaluación izquierda a derecha\n");
+    }
+    printf("Suma de verificación de la matriz resultado: %.6e\n", sum);
+
+    free_matrix(reference, dims[0]);
+    free_chain_tree(root);
+    for (int m = 0; m < count; m++) {
+        free_matrix(inputs[m], dims[m]);
+    }
+    free(inputs);
+
+    return correct ? 0 : 1;
+}
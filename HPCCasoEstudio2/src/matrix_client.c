@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include "job_protocol.h"
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Matriz rows x cols contigua con los mismos valores que initialize_matrix
+int* generate_flat(int rows, int cols, int seed) {
+    int *M = (int*)malloc((size_t)rows * cols * sizeof(int));
+    srand(seed);
+    for (size_t i = 0; i < (size_t)rows * cols; i++) {
+        M[i] = rand() % 100;
+    }
+    return M;
+}
+
+// Escribe una matriz aleatoria como int32 row-major para el modo --archivos
+int write_matrix_file(const char *path, int rows, int cols, int seed) {
+    int *M = generate_flat(rows, cols, seed);
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        free(M);
+        return 0;
+    }
+    size_t written = fwrite(M, sizeof(int), (size_t)rows * cols, f);
+    fclose(f);
+    free(M);
+    return written == (size_t)rows * cols;
+}
+
+void print_stats(const job_stats_t *s) {
+    printf("Hilos de cálculo: %u\n", s->workers);
+    printf("Trabajos: %llu (errores %llu), en %.1f s: %.2f trabajos/s, %.3f GFLOPS\n",
+           (unsigned long long)s->jobs, (unsigned long long)s->errors, s->uptime,
+           s->jobs / s->uptime, s->flops / (s->uptime * 1e9));
+    printf("Lotes: %llu con %llu trabajos (%.2f por lote); repartidos entre hilos: %llu\n",
+           (unsigned long long)s->batches, (unsigned long long)s->batched_jobs,
+           s->batches ? (double)s->batched_jobs / s->batches : 0.0, (unsigned long long)s->split_jobs);
+    printf("Latencia: media %.6f s, p50 <= %.6f s, p99 <= %.6f s, máx %.6f s\n",
+           s->jobs ? s->latency_sum / (s->jobs + s->errors) : 0.0,
+           job_latency_percentile(s, 50), job_latency_percentile(s, 99), s->latency_max);
+    printf("Arena: %llu aciertos, %llu fallos, %.2f MB retenidos\n",
+           (unsigned long long)s->arena_hits, (unsigned long long)s->arena_misses,
+           s->arena_bytes / 1048576.0);
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [semilla_A] [semilla_B]\n", program_name);
+    printf("     %s --inline <tamaño_matriz> [semilla_A] [semilla_B]\n", program_name);
+    printf("     %s --archivos <A.bin> <B.bin> <m> <k> <n>\n", program_name);
+    printf("     %s --generar <archivo.bin> <filas> <columnas> <semilla>\n", program_name);
+    printf("     %s --stats | --detener\n", program_name);
+    printf("  Por defecto el servidor genera A y B con las semillas y devuelve la suma.\n");
+    printf("  --inline envía A y B generadas aquí y recibe C completa.\n");
+    printf("  --archivos hace que el servidor lea A (m x k) y B (k x n) int32 row-major.\n");
+    printf("  Socket: $MATMUL_SOCKET (por defecto %s)\n", JOB_DEFAULT_SOCKET);
+    printf("\nEjemplo: %s 512 123 456\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    job_request_t req;
+    int *A = NULL, *B = NULL;
+
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "--generar") == 0) {
+        if (argc != 6 || atoi(argv[3]) <= 0 || atoi(argv[4]) <= 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (!write_matrix_file(argv[2], atoi(argv[3]), atoi(argv[4]), atoi(argv[5]))) {
+            perror(argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+
+    int fd = job_connect(job_socket_path());
+    if (fd < 0) {
+        printf("Error: No se pudo conectar a %s\n", job_socket_path());
+        return 1;
+    }
+
+    if (strcmp(argv[1], "--stats") == 0 || strcmp(argv[1], "--detener") == 0) {
+        int stats = strcmp(argv[1], "--stats") == 0;
+        job_request_init(&req, stats ? JOB_OP_STATS : JOB_OP_SHUTDOWN);
+        if (!job_write_full(fd, &req, sizeof(req))) {
+            printf("Error: No se pudo enviar la petición\n");
+            return 1;
+        }
+        if (stats) {
+            job_stats_t s;
+            if (!job_read_full(fd, &s, sizeof(s)) || s.magic != JOB_MAGIC) {
+                printf("Error: Respuesta inválida del servidor\n");
+                return 1;
+            }
+            print_stats(&s);
+        } else {
+            job_response_t resp;
+            if (job_read_full(fd, &resp, sizeof(resp))) printf("Servidor detenido\n");
+        }
+        close(fd);
+        return 0;
+    }
+
+    job_request_init(&req, JOB_OP_MULTIPLY);
+    if (strcmp(argv[1], "--archivos") == 0) {
+        if (argc != 7) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        req.source = JOB_SRC_FILES;
+        snprintf(req.path_a, sizeof(req.path_a), "%s", argv[2]);
+        snprintf(req.path_b, sizeof(req.path_b), "%s", argv[3]);
+        req.m = (uint32_t)atoi(argv[4]);
+        req.k = (uint32_t)atoi(argv[5]);
+        req.n = (uint32_t)atoi(argv[6]);
+        req.reply = JOB_REPLY_CHECKSUM;
+    } else {
+        int inline_data = strcmp(argv[1], "--inline") == 0;
+        int first = inline_data ? 2 : 1;
+        if (argc <= first || argc > first + 3) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        int size = atoi(argv[first]);
+        if (size <= 0) {
+            printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+            return 1;
+        }
+        req.m = req.k = req.n = (uint32_t)size;
+        req.seed_a = (argc > first + 1) ? atoi(argv[first + 1]) : (int)time(NULL);
+        req.seed_b = (argc > first + 2) ? atoi(argv[first + 2]) : req.seed_a + 1;
+        if (inline_data) {
+            req.source = JOB_SRC_INLINE;
+            req.reply = JOB_REPLY_MATRIX;
+            A = generate_flat(size, size, req.seed_a);
+            B = generate_flat(size, size, req.seed_b);
+        } else {
+            req.source = JOB_SRC_SEEDS;
+            req.reply = JOB_REPLY_CHECKSUM;
+        }
+    }
+
+    double wall_start = get_wall_time();
+    int ok = job_write_full(fd, &req, sizeof(req));
+    if (ok && A != NULL) {
+        ok = job_write_full(fd, A, (size_t)req.m * req.k * sizeof(int)) &&
+             job_write_full(fd, B, (size_t)req.k * req.n * sizeof(int));
+    }
+    job_response_t resp;
+    if (!ok || !job_read_full(fd, &resp, sizeof(resp)) || resp.magic != JOB_MAGIC) {
+        printf("Error: Falló la comunicación con el servidor\n");
+        return 1;
+    }
+    if (resp.status != JOB_OK) {
+        printf("✗ Error: el servidor rechazó el trabajo (código %d)\n", resp.status);
+        return 1;
+    }
+
+    long long sum = resp.checksum;
+    if (req.reply == JOB_REPLY_MATRIX) {
+        size_t count = (size_t)resp.m * resp.n;
+        int *C = (int*)malloc(count * sizeof(int));
+        if (!job_read_full(fd, C, count * sizeof(int))) {
+            printf("Error: Respuesta incompleta del servidor\n");
+            return 1;
+        }
+        long long local = 0;
+        for (size_t i = 0; i < count; i++) local += C[i];
+        if (local != sum) {
+            printf("✗ Error: la suma de C recibida (%lld) no coincide con la del servidor (%lld)\n", local, sum);
+        }
+        free(C);
+    }
+    double wall_end = get_wall_time();
+    close(fd);
+
+    printf("Lote de %u trabajos, %u hilos; en cola %.6f s, cálculo %.6f s, servidor %.6f s\n",
+           resp.batch_size, resp.workers, resp.queue_wait, resp.compute_time, resp.server_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+    printf("Suma de verificación de la matriz resultado: %lld\n", sum);
+
+    free(A);
+    free(B);
+    return 0;
+}
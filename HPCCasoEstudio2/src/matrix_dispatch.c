@@ -0,0 +1,552 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <omp.h>
+
+#define BLOCK_SIZE 32
+// Bloques del GEMM empaquetado: panel de B de KC x NC contiguo, filas de A de a MR
+#define KC 256
+#define NC 512
+#define MR 4
+
+#define MAX_SIZES 32
+#define MAX_THREAD_OPTIONS 8
+#define MAX_PROFILE_ENTRIES 64
+#define PROFILE_DEFAULT_DIR ".dispatch_profile"
+#define PROFILE_PATH_MAX 512
+
+// Motores disponibles para el despachador
+typedef enum {
+    ENGINE_SEQ = 0,          // i-k-j sin bloques, un hilo
+    ENGINE_BLOCKED_SEQ,      // Blocking 32x32, un hilo
+    ENGINE_OMP_BLOCKED,      // Blocking 32x32 con OpenMP
+    ENGINE_PACKED,           // Panel de B empaquetado + micro-kernel MR filas, OpenMP
+    NUM_ENGINES
+} engine_t;
+
+static const char *engine_names[NUM_ENGINES] = {"secuencial", "blocking_seq", "omp_blocking", "packed"};
+
+// Punto de cruce medido: a partir de `n` conviene `engine` con `threads` hilos
+typedef struct {
+    int n;
+    engine_t engine;
+    int threads;
+    double wall;
+} dispatch_entry_t;
+
+// Perfil de calibración de una máquina, ordenado por n
+typedef struct {
+    char host[64];
+    int cpus;
+    int count;
+    dispatch_entry_t entries[MAX_PROFILE_ENTRIES];
+} dispatch_profile_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para inicializar una matriz con valores aleatorios
+void initialize_matrix(int **matrix, int size, int seed) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 100;
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+long long checksum(int **C, int size) {
+    long long sum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += C[i][j];
+        }
+    }
+    return sum;
+}
+
+// ---------------------------------------------------------------------------
+// Motores
+// ---------------------------------------------------------------------------
+
+void matmul_seq(int **A, int **B, int **C, int size) {
+    for (int i = 0; i < size; i++) {
+        memset(C[i], 0, size * sizeof(int));
+        for (int k = 0; k < size; k++) {
+            int a = A[i][k];
+            int *b_row = B[k];
+            int *c_row = C[i];
+            for (int j = 0; j < size; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+// Bloque (ii, jj, kk) de C += A * B, recorrido i-k-j dentro del bloque
+static inline void block_update(int **A, int **B, int **C, int size, int ii, int jj, int kk) {
+    int i_end = (ii + BLOCK_SIZE < size) ? ii + BLOCK_SIZE : size;
+    int j_end = (jj + BLOCK_SIZE < size) ? jj + BLOCK_SIZE : size;
+    int k_end = (kk + BLOCK_SIZE < size) ? kk + BLOCK_SIZE : size;
+    for (int i = ii; i < i_end; i++) {
+        int *c_row = C[i];
+        for (int k = kk; k < k_end; k++) {
+            int a = A[i][k];
+            int *b_row = B[k];
+            for (int j = jj; j < j_end; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+void matmul_blocked_seq(int **A, int **B, int **C, int size) {
+    for (int i = 0; i < size; i++) {
+        memset(C[i], 0, size * sizeof(int));
+    }
+    for (int ii = 0; ii < size; ii += BLOCK_SIZE) {
+        for (int kk = 0; kk < size; kk += BLOCK_SIZE) {
+            for (int jj = 0; jj < size; jj += BLOCK_SIZE) {
+                block_update(A, B, C, size, ii, jj, kk);
+            }
+        }
+    }
+}
+
+// Cada hilo es dueño de bloques (ii, jj) completos de C: no hay escrituras compartidas
+void matmul_omp_blocked(int **A, int **B, int **C, int size, int threads) {
+    #pragma omp parallel num_threads(threads)
+    {
+        #pragma omp for
+        for (int i = 0; i < size; i++) {
+            memset(C[i], 0, size * sizeof(int));
+        }
+        #pragma omp for collapse(2) schedule(static)
+        for (int ii = 0; ii < size; ii += BLOCK_SIZE) {
+            for (int jj = 0; jj < size; jj += BLOCK_SIZE) {
+                for (int kk = 0; kk < size; kk += BLOCK_SIZE) {
+                    block_update(A, B, C, size, ii, jj, kk);
+                }
+            }
+        }
+    }
+}
+
+// GEMM empaquetado: por cada panel (kk, jj) de B se copia un bloque KC x NC a un
+// buffer contiguo compartido y los hilos se reparten las filas de A de a MR.
+// El micro-kernel mantiene MR filas de C en curso para reutilizar cada fila del panel.
+void matmul_packed(int **A, int **B, int **C, int size, int threads) {
+    int *panel = (int*)malloc((size_t)KC * NC * sizeof(int));
+
+    #pragma omp parallel num_threads(threads)
+    {
+        #pragma omp for
+        for (int i = 0; i < size; i++) {
+            memset(C[i], 0, size * sizeof(int));
+        }
+        for (int jj = 0; jj < size; jj += NC) {
+            int nc = (jj + NC < size) ? NC : size - jj;
+            for (int kk = 0; kk < size; kk += KC) {
+                int kc = (kk + KC < size) ? KC : size - kk;
+
+                #pragma omp for schedule(static)
+                for (int k = 0; k < kc; k++) {
+                    memcpy(&panel[(size_t)k * nc], &B[kk + k][jj], nc * sizeof(int));
+                }
+                // Barrera implícita del for: el panel está completo antes de usarlo
+
+                #pragma omp for schedule(static)
+                for (int i0 = 0; i0 < size; i0 += MR) {
+                    int mr = (i0 + MR < size) ? MR : size - i0;
+                    if (mr == MR) {
+                        int *c0 = &C[i0][jj], *c1 = &C[i0 + 1][jj];
+                        int *c2 = &C[i0 + 2][jj], *c3 = &C[i0 + 3][jj];
+                        for (int k = 0; k < kc; k++) {
+                            int a0 = A[i0][kk + k], a1 = A[i0 + 1][kk + k];
+                            int a2 = A[i0 + 2][kk + k], a3 = A[i0 + 3][kk + k];
+                            const int *p = &panel[(size_t)k * nc];
+                            for (int j = 0; j < nc; j++) {
+                                int b = p[j];
+                                c0[j] += a0 * b;
+                                c1[j] += a1 * b;
+                                c2[j] += a2 * b;
+                                c3[j] += a3 * b;
+                            }
+                        }
+                    } else {
+                        for (int i = i0; i < i0 + mr; i++) {
+                            int *c_row = &C[i][jj];
+                            for (int k = 0; k < kc; k++) {
+                                int a = A[i][kk + k];
+                                const int *p = &panel[(size_t)k * nc];
+                                for (int j = 0; j < nc; j++) {
+                                    c_row[j] += a * p[j];
+                                }
+                            }
+                        }
+                    }
+                }
+                // Barrera implícita: nadie reescribe el panel mientras otro lo usa
+            }
+        }
+    }
+
+    free(panel);
+}
+
+void run_engine(engine_t engine, int threads, int **A, int **B, int **C, int size) {
+    switch (engine) {
+    case ENGINE_SEQ:         matmul_seq(A, B, C, size); break;
+    case ENGINE_BLOCKED_SEQ: matmul_blocked_seq(A, B, C, size); break;
+    case ENGINE_OMP_BLOCKED: matmul_omp_blocked(A, B, C, size, threads); break;
+    case ENGINE_PACKED:      matmul_packed(A, B, C, size, threads); break;
+    default: break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Perfil por máquina
+// ---------------------------------------------------------------------------
+
+// Ruta del perfil: $DISPATCH_PROFILE si está definida, si no
+// $DISPATCH_PROFILE_DIR/<hostname>.csv (por defecto .dispatch_profile/<hostname>.csv)
+void profile_path(char *out, size_t len) {
+    const char *file = getenv("DISPATCH_PROFILE");
+    if (file != NULL && file[0] != '\0') {
+        snprintf(out, len, "%s", file);
+        return;
+    }
+    const char *dir = getenv("DISPATCH_PROFILE_DIR");
+    if (dir == NULL || dir[0] == '\0') dir = PROFILE_DEFAULT_DIR;
+    char host[64] = "localhost";
+    gethostname(host, sizeof(host) - 1);
+    snprintf(out, len, "%s/%s.csv", dir, host);
+}
+
+engine_t engine_from_name(const char *name) {
+    for (int e = 0; e < NUM_ENGINES; e++) {
+        if (strcmp(name, engine_names[e]) == 0) return (engine_t)e;
+    }
+    return NUM_ENGINES;
+}
+
+// Carga el perfil. Devuelve 0 si no existe, está mal formado o fue medido con
+// otro número de CPUs (los cruces dependen del número de núcleos).
+int profile_load(dispatch_profile_t *prof, int cpus) {
+    char path[PROFILE_PATH_MAX];
+    char line[256];
+    profile_path(path, sizeof(path));
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+
+    prof->count = 0;
+    if (fgets(line, sizeof(line), f) == NULL ||
+        sscanf(line, "# host=%63[^;];cpus=%d", prof->host, &prof->cpus) != 2 ||
+        prof->cpus != cpus) {
+        fclose(f);
+        return 0;
+    }
+    while (fgets(line, sizeof(line), f) != NULL && prof->count < MAX_PROFILE_ENTRIES) {
+        dispatch_entry_t *e = &prof->entries[prof->count];
+        char name[32];
+        if (line[0] == '#' || line[0] == 'n') continue;  // Comentarios y encabezado
+        if (sscanf(line, "%d,%31[^,],%d,%lf", &e->n, name, &e->threads, &e->wall) != 4) continue;
+        e->engine = engine_from_name(name);
+        if (e->engine == NUM_ENGINES || e->threads <= 0) continue;
+        prof->count++;
+    }
+    fclose(f);
+    return prof->count > 0;
+}
+
+int profile_store(const dispatch_profile_t *prof) {
+    char path[PROFILE_PATH_MAX];
+    char tmp[PROFILE_PATH_MAX + 8];
+    profile_path(path, sizeof(path));
+
+    // Crea el directorio por defecto si hace falta (un nivel)
+    char *slash = strrchr(path, '/');
+    if (slash != NULL) {
+        *slash = '\0';
+        if (mkdir(path, 0755) != 0 && errno != EEXIST) return 0;
+        *slash = '/';
+    }
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "w");
+    if (f == NULL) return 0;
+    fprintf(f, "# host=%s;cpus=%d\n", prof->host, prof->cpus);
+    fprintf(f, "n,motor,hilos,tiempo_wall\n");
+    for (int i = 0; i < prof->count; i++) {
+        const dispatch_entry_t *e = &prof->entries[i];
+        fprintf(f, "%d,%s,%d,%.6f\n", e->n, engine_names[e->engine], e->threads, e->wall);
+    }
+    if (fclose(f) != 0) return 0;
+    return rename(tmp, path) == 0;
+}
+
+// Regla fija para cuando no hay perfil: secuencial hasta donde results.csv
+// muestra que OpenMP no compensa, blocking secuencial mientras la matriz entra
+// en caché y GEMM empaquetado con todos los hilos de ahí en adelante.
+void default_choice(int size, int cpus, engine_t *engine, int *threads) {
+    if (size < 128) {
+        *engine = ENGINE_SEQ;
+        *threads = 1;
+    } else if (size < 256 || cpus == 1) {
+        *engine = ENGINE_BLOCKED_SEQ;
+        *threads = 1;
+    } else {
+        *engine = ENGINE_PACKED;
+        *threads = cpus;
+    }
+}
+
+// Elige motor e hilos para n: la entrada calibrada con el mayor n <= size
+// (o la más pequeña si size está por debajo de todas)
+void dispatch_choose(const dispatch_profile_t *prof, int size, int cpus, engine_t *engine, int *threads) {
+    if (prof == NULL || prof->count == 0) {
+        default_choice(size, cpus, engine, threads);
+        return;
+    }
+    // El perfil guarda el orden de calibración: se busca por n y no por posición
+    const dispatch_entry_t *best = NULL, *smallest = &prof->entries[0];
+    for (int i = 0; i < prof->count; i++) {
+        const dispatch_entry_t *e = &prof->entries[i];
+        if (e->n < smallest->n) smallest = e;
+        if (e->n <= size && (best == NULL || e->n > best->n)) best = e;
+    }
+    if (best == NULL) best = smallest;
+    *engine = best->engine;
+    *threads = best->threads;
+}
+
+// Punto de entrada único: C = A * B con el motor que el perfil indica para n
+static dispatch_profile_t g_profile;
+static int g_profile_state = -1;   // -1 sin cargar, 0 sin perfil, 1 cargado
+
+void matmul(int **A, int **B, int **C, int size) {
+    engine_t engine;
+    int threads;
+    int cpus = omp_get_num_procs();
+    if (g_profile_state < 0) {
+        g_profile_state = profile_load(&g_profile, cpus);
+    }
+    dispatch_choose(g_profile_state ? &g_profile : NULL, size, cpus, &engine, &threads);
+    run_engine(engine, threads, A, B, C, size);
+}
+
+// ---------------------------------------------------------------------------
+// Calibración
+// ---------------------------------------------------------------------------
+
+// Hilos a probar: 1, 2, 4, ... y el máximo disponible
+int thread_options(int cpus, int *out) {
+    int count = 0;
+    for (int t = 1; t < cpus && count < MAX_THREAD_OPTIONS - 1; t *= 2) {
+        out[count++] = t;
+    }
+    out[count++] = cpus;
+    return count;
+}
+
+// Mínimo de `repeats` corridas del motor; devuelve la suma para verificar
+double time_engine(engine_t engine, int threads, int **A, int **B, int **C, int size,
+                   int repeats, long long *sum) {
+    double min_wall = -1.0;
+    for (int r = 0; r < repeats; r++) {
+        double wall_start = get_wall_time();
+        run_engine(engine, threads, A, B, C, size);
+        double wall = get_wall_time() - wall_start;
+        if (min_wall < 0 || wall < min_wall) min_wall = wall;
+    }
+    *sum = checksum(C, size);
+    return min_wall;
+}
+
+int calibrate(const int *sizes, int num_sizes, int repeats, int seed_A, int seed_B) {
+    dispatch_profile_t prof;
+    int cpus = omp_get_num_procs();
+    int options[MAX_THREAD_OPTIONS];
+    int num_options = thread_options(cpus, options);
+    int all_ok = 1;
+
+    memset(&prof, 0, sizeof(prof));
+    gethostname(prof.host, sizeof(prof.host) - 1);
+    prof.cpus = cpus;
+
+    printf("Calibrando en %s (%d CPUs), %d repeticiones por punto\n", prof.host, cpus, repeats);
+    for (int s = 0; s < num_sizes && prof.count < MAX_PROFILE_ENTRIES; s++) {
+        int n = sizes[s];
+        int **A = allocate_matrix(n);
+        int **B = allocate_matrix(n);
+        int **C = allocate_matrix(n);
+        initialize_matrix(A, n, seed_A);
+        initialize_matrix(B, n, seed_B);
+
+        printf("\n--- Tamaño %d ---\n", n);
+        dispatch_entry_t *best = &prof.entries[prof.count];
+        best->n = n;
+        best->wall = -1.0;
+        long long reference = 0;
+        for (int e = 0; e < NUM_ENGINES; e++) {
+            int parallel = (e == ENGINE_OMP_BLOCKED || e == ENGINE_PACKED);
+            for (int o = 0; o < (parallel ? num_options : 1); o++) {
+                int threads = parallel ? options[o] : 1;
+                long long sum;
+                double wall = time_engine((engine_t)e, threads, A, B, C, n, repeats, &sum);
+                if (e == ENGINE_SEQ) {
+                    reference = sum;
+                } else if (sum != reference) {
+                    printf("✗ %s (%d hilos): suma %lld (esperado %lld)\n",
+                           engine_names[e], threads, sum, reference);
+                    all_ok = 0;
+                    continue;
+                }
+                printf("%-14s %2d hilos  %.6f s\n", engine_names[e], threads, wall);
+                if (best->wall < 0 || wall < best->wall) {
+                    best->engine = (engine_t)e;
+                    best->threads = threads;
+                    best->wall = wall;
+                }
+            }
+        }
+        printf("Elegido para %d: %s con %d hilos\n", n, engine_names[best->engine], best->threads);
+        prof.count++;
+
+        free_matrix(A, n);
+        free_matrix(B, n);
+        free_matrix(C, n);
+    }
+
+    char path[PROFILE_PATH_MAX];
+    profile_path(path, sizeof(path));
+    if (profile_store(&prof)) {
+        printf("\nPerfil guardado en %s\n", path);
+    } else {
+        printf("\nAdvertencia: no se pudo escribir el perfil en %s\n", path);
+        all_ok = 0;
+    }
+    return all_ok;
+}
+
+int parse_sizes(const char *arg, int *sizes) {
+    int count = 0;
+    char *list = strdup(arg);
+    for (char *tok = strtok(list, ","); tok != NULL && count < MAX_SIZES; tok = strtok(NULL, ",")) {
+        sizes[count] = atoi(tok);
+        if (sizes[count] <= 0) {
+            free(list);
+            return -1;
+        }
+        count++;
+    }
+    free(list);
+    return count;
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [semilla_A] [semilla_B]\n", program_name);
+    printf("     %s --calibrar [tamaños] [repeticiones]\n", program_name);
+    printf("  tamaño_matriz: Multiplica con el motor que el perfil indica para ese tamaño\n");
+    printf("  --calibrar: Mide todos los motores e hilos para cada tamaño (por defecto\n");
+    printf("              64,128,256,512,1024, 3 repeticiones) y guarda el perfil\n");
+    printf("  Perfil: $DISPATCH_PROFILE, o $DISPATCH_PROFILE_DIR/<host>.csv (por defecto %s/<host>.csv)\n",
+           PROFILE_DEFAULT_DIR);
+    printf("\nEjemplo: %s --calibrar 64,128,256,512,1024 && %s 800 123 456\n", program_name, program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int seed_A, seed_B;
+    double start_time, end_time, wall_start, wall_end;
+
+    if (argc >= 2 && strcmp(argv[1], "--calibrar") == 0) {
+        int sizes[MAX_SIZES];
+        int num_sizes = parse_sizes(argc >= 3 ? argv[2] : "64,128,256,512,1024", sizes);
+        int repeats = (argc >= 4) ? atoi(argv[3]) : 3;
+        if (num_sizes <= 0 || argc > 4) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (repeats <= 0) repeats = 1;
+        return calibrate(sizes, num_sizes, repeats, 12345, 54321) ? 0 : 1;
+    }
+
+    if (argc < 2 || argc > 4) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    seed_A = (argc >= 3) ? atoi(argv[2]) : (int)time(NULL);
+    seed_B = (argc == 4) ? atoi(argv[3]) : seed_A + 1;
+
+    int **A = allocate_matrix(size);
+    int **B = allocate_matrix(size);
+    int **C = allocate_matrix(size);
+    initialize_matrix(A, size, seed_A);
+    initialize_matrix(B, size, seed_B);
+
+    int cpus = omp_get_num_procs();
+    engine_t engine;
+    int threads;
+    g_profile_state = profile_load(&g_profile, cpus);
+    dispatch_choose(g_profile_state ? &g_profile : NULL, size, cpus, &engine, &threads);
+    printf("Perfil: %s\n", g_profile_state ? "calibrado" : "sin calibrar (regla por defecto)");
+    printf("Motor elegido: %s con %d hilos\n", engine_names[engine], threads);
+
+    start_time = get_user_time();
+    wall_start = get_wall_time();
+    matmul(A, B, C, size);
+    end_time = get_user_time();
+    wall_end = get_wall_time();
+
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+    printf("Suma de verificación de la matriz resultado: %lld\n", checksum(C, size));
+
+    free_matrix(A, size);
+    free_matrix(B, size);
+    free_matrix(C, size);
+
+    return 0;
+}
@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#define BLOCK_SIZE 32
+// Si el costo incremental supera esta fracción de n³ se recalcula todo:
+// el kernel por filas/columnas es menos eficiente que el blocking completo.
+#define INCREMENTAL_THRESHOLD 0.5
+
+// Estado persistente entre iteraciones: últimas A, B y C = A * B
+typedef struct {
+    int **A;
+    int **B;
+    int **C;
+    int size;
+    int *row_mark;       // Marcas de filas ya recalculadas en la actualización actual
+    long long incremental_updates;
+    long long full_updates;
+} incremental_state_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para inicializar una matriz con valores aleatorios
+void initialize_matrix(int **matrix, int size, int seed) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 100;
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// Multiplicación completa con blocking (mismo recorrido que matrix_multiplication_blocking.c)
+void matrix_multiply_blocking(int **A, int **B, int **C, int size) {
+    int i, j, k, ii, jj, kk;
+    #pragma omp parallel for private(j)
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            C[i][j] = 0;
+        }
+    }
+    #pragma omp parallel for collapse(2) private(i, j, k, kk)
+    for (ii = 0; ii < size; ii += BLOCK_SIZE) {
+        for (jj = 0; jj < size; jj += BLOCK_SIZE) {
+            for (kk = 0; kk < size; kk += BLOCK_SIZE) {
+                for (i = ii; i < ii + BLOCK_SIZE && i < size; i++) {
+                    for (j = jj; j < jj + BLOCK_SIZE && j < size; j++) {
+                        int sum = C[i][j];
+                        for (k = kk; k < kk + BLOCK_SIZE && k < size; k++) {
+                            sum += A[i][k] * B[k][j];
+                        }
+                        C[i][j] = sum;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Recalcula las filas indicadas de C: C[i][:] = A[i][:] * B, con bloques de k y j
+void recompute_rows(incremental_state_t *st, const int *rows, int num_rows) {
+    int size = st->size;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int r = 0; r < num_rows; r++) {
+        int i = rows[r];
+        int *c_row = st->C[i];
+        memset(c_row, 0, size * sizeof(int));
+        for (int kk = 0; kk < size; kk += BLOCK_SIZE) {
+            int k_end = (kk + BLOCK_SIZE < size) ? kk + BLOCK_SIZE : size;
+            for (int jj = 0; jj < size; jj += BLOCK_SIZE) {
+                int j_end = (jj + BLOCK_SIZE < size) ? jj + BLOCK_SIZE : size;
+                for (int k = kk; k < k_end; k++) {
+                    int a = st->A[i][k];
+                    int *b_row = st->B[k];
+                    for (int j = jj; j < j_end; j++) {
+                        c_row[j] += a * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Recalcula las columnas indicadas de C. Las columnas de B se empaquetan de
+// forma contigua para que cada producto punto recorra memoria secuencial.
+// Las filas ya recalculadas (row_mark) se saltan.
+void recompute_cols(incremental_state_t *st, const int *cols, int num_cols) {
+    int size = st->size;
+    int *col_buffer = (int*)malloc((size_t)num_cols * size * sizeof(int));
+    for (int c = 0; c < num_cols; c++) {
+        for (int k = 0; k < size; k++) {
+            col_buffer[(size_t)c * size + k] = st->B[k][cols[c]];
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for (int ii = 0; ii < size; ii += BLOCK_SIZE) {
+        int i_end = (ii + BLOCK_SIZE < size) ? ii + BLOCK_SIZE : size;
+        for (int c = 0; c < num_cols; c++) {
+            const int *b_col = &col_buffer[(size_t)c * size];
+            for (int i = ii; i < i_end; i++) {
+                if (st->row_mark[i]) continue;
+                const int *a_row = st->A[i];
+                int sum = 0;
+                for (int k = 0; k < size; k++) {
+                    sum += a_row[k] * b_col[k];
+                }
+                st->C[i][cols[c]] = sum;
+            }
+        }
+    }
+    free(col_buffer);
+}
+
+incremental_state_t* incremental_create(int **A, int **B, int size) {
+    incremental_state_t *st = (incremental_state_t*)calloc(1, sizeof(incremental_state_t));
+    st->A = A;
+    st->B = B;
+    st->C = allocate_matrix(size);
+    st->size = size;
+    st->row_mark = (int*)calloc(size, sizeof(int));
+    matrix_multiply_blocking(A, B, st->C, size);
+    st->full_updates++;
+    return st;
+}
+
+void incremental_destroy(incremental_state_t *st) {
+    free_matrix(st->C, st->size);
+    free(st->row_mark);
+    free(st);
+}
+
+// Actualiza C después de que el llamador modificó en st->A las filas `rows`
+// y/o en st->B las columnas `cols`. Devuelve 1 si hizo recálculo incremental
+// y 0 si el costo superó el umbral y recalculó todo.
+int incremental_update(incremental_state_t *st, const int *rows, int num_rows,
+                       const int *cols, int num_cols) {
+    double n = (double)st->size;
+    double cost = (num_rows + num_cols) * n * n;
+    if (cost > INCREMENTAL_THRESHOLD * n * n * n) {
+        matrix_multiply_blocking(st->A, st->B, st->C, st->size);
+        st->full_updates++;
+        return 0;
+    }
+
+    if (num_rows > 0) {
+        recompute_rows(st, rows, num_rows);
+    }
+    if (num_cols > 0) {
+        for (int r = 0; r < num_rows; r++) st->row_mark[rows[r]] = 1;
+        recompute_cols(st, cols, num_cols);
+        for (int r = 0; r < num_rows; r++) st->row_mark[rows[r]] = 0;
+    }
+    st->incremental_updates++;
+    return 1;
+}
+
+// Elige `count` índices distintos en [0, size) por rechazo
+void pick_indices(int *out, int count, int size, int *seen) {
+    memset(seen, 0, size * sizeof(int));
+    for (int c = 0; c < count; c++) {
+        int idx;
+        do {
+            idx = rand() % size;
+        } while (seen[idx]);
+        seen[idx] = 1;
+        out[c] = idx;
+    }
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [filas_A] [columnas_B] [iteraciones] [semilla_A] [semilla_B]\n", program_name);
+    printf("  tamaño_matriz: Tamaño de las matrices cuadradas (obligatorio)\n");
+    printf("  filas_A: Filas de A que cambian en cada iteración (opcional, por defecto: 4)\n");
+    printf("  columnas_B: Columnas de B que cambian en cada iteración (opcional, por defecto: 0)\n");
+    printf("  iteraciones: Número de actualizaciones (opcional, por defecto: 10)\n");
+    printf("  semilla_A: Semilla para generar matriz A (opcional, por defecto: tiempo actual)\n");
+    printf("  semilla_B: Semilla para generar matriz B (opcional, por defecto: tiempo actual + 1)\n");
+    printf("\nEjemplo: %s 1024 8 2 20 123 456\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int num_rows = 4, num_cols = 0, iterations = 10;
+    int seed_A, seed_B;
+
+    if (argc < 2 || argc > 7) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    if (argc >= 3) num_rows = atoi(argv[2]);
+    if (argc >= 4) num_cols = atoi(argv[3]);
+    if (argc >= 5) iterations = atoi(argv[4]);
+    if (num_rows < 0 || num_rows > size || num_cols < 0 || num_cols > size || iterations <= 0) {
+        printf("Error: filas/columnas deben estar en [0, tamaño] e iteraciones ser positivo.\n");
+        return 1;
+    }
+    seed_A = (argc >= 6) ? atoi(argv[5]) : (int)time(NULL);
+    seed_B = (argc == 7) ? atoi(argv[6]) : seed_A + 1;
+
+    int **A = allocate_matrix(size);
+    int **B = allocate_matrix(size);
+    int **C_fresh = allocate_matrix(size);
+    int *rows = (int*)malloc((num_rows > 0 ? num_rows : 1) * sizeof(int));
+    int *cols = (int*)malloc((num_cols > 0 ? num_cols : 1) * sizeof(int));
+    int *seen = (int*)malloc(size * sizeof(int));
+
+    initialize_matrix(A, size, seed_A);
+    initialize_matrix(B, size, seed_B);
+
+    // Costo de referencia: una multiplicación completa con blocking
+    double wall_start = get_wall_time();
+    incremental_state_t *st = incremental_create(A, B, size);
+    double full_wall = get_wall_time() - wall_start;
+    printf("Multiplicación completa inicial: %.6f segundos\n", full_wall);
+
+    // Bucle de servicio: cambian algunas filas de A y columnas de B
+    srand(seed_A ^ seed_B);
+    double incremental_wall = 0.0;
+    for (int it = 0; it < iterations; it++) {
+        pick_indices(rows, num_rows, size, seen);
+        for (int r = 0; r < num_rows; r++) {
+            for (int k = 0; k < size; k++) A[rows[r]][k] = rand() % 100;
+        }
+        pick_indices(cols, num_cols, size, seen);
+        for (int c = 0; c < num_cols; c++) {
+            for (int k = 0; k < size; k++) B[k][cols[c]] = rand() % 100;
+        }
+
+        wall_start = get_wall_time();
+        incremental_update(st, rows, num_rows, cols, num_cols);
+        incremental_wall += get_wall_time() - wall_start;
+    }
+
+    printf("Actualizaciones incrementales: %lld, recálculos completos: %lld\n",
+           st->incremental_updates, st->full_updates - 1);
+    printf("Tiempo real (wall time): %.6f segundos (%.6f por iteración)\n",
+           incremental_wall, incremental_wall / iterations);
+    printf("Speedup estimado vs recálculo completo: %.2fx\n",
+           (full_wall * iterations) / incremental_wall);
+
+    // Verificación contra una multiplicación nueva con las A y B finales
+    matrix_multiply_blocking(A, B, C_fresh, size);
+    int correct = 1;
+    for (int i = 0; i < size && correct; i++) {
+        if (memcmp(C_fresh[i], st->C[i], size * sizeof(int)) != 0) {
+            printf("✗ Error: la fila %d de C incremental no coincide\n", i);
+            correct = 0;
+        }
+    }
+    if (correct) {
+        printf("✓ Verificación exitosa: C incremental coincide con un recálculo completo\n");
+    }
+
+    long long sum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += st->C[i][j];
+        }
+    }
+    printf("Suma de verificación de la matriz resultado: %lld\n", sum);
+
+    incremental_destroy(st);
+    free_matrix(A, size);
+    free_matrix(B, size);
+    free_matrix(C_fresh, size);
+    free(rows);
+    free(cols);
+    free(seen);
+
+    return correct ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "job_protocol.h"
+
+#define MAX_SIZES 16
+
+// Parámetros compartidos por los clientes
+typedef struct {
+    int sizes[MAX_SIZES];
+    int num_sizes;
+    int jobs_per_client;
+    int inline_data;
+    long long expected[MAX_SIZES];   // Suma de referencia por tamaño
+    // A y B por tamaño, generadas una vez en main (rand() no es seguro entre
+    // hilos); los clientes inline solo las leen
+    int *inputs_a[MAX_SIZES];
+    int *inputs_b[MAX_SIZES];
+} load_config_t;
+
+typedef struct {
+    int id;
+    const load_config_t *cfg;
+    double *latencies;               // Una por trabajo
+    int completed;
+    int mismatches;
+    int errors;
+    unsigned int rng;
+} client_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+int* generate_flat(int n, int seed) {
+    int *M = (int*)malloc((size_t)n * n * sizeof(int));
+    srand(seed);
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        M[i] = rand() % 100;
+    }
+    return M;
+}
+
+// Semillas fijas por tamaño: todas las respuestas de un tamaño deben dar la
+// misma suma, lo que detecta errores de lotes o de reparto entre hilos
+static int seed_a_for(int n) { return 12345 + n; }
+static int seed_b_for(int n) { return 54321 + n; }
+
+// Referencia local i-k-j, una vez por tamaño antes de empezar la carga
+long long local_checksum(const int *A, const int *B, int n) {
+    int *row = (int*)malloc(n * sizeof(int));
+    long long sum = 0;
+    for (int i = 0; i < n; i++) {
+        memset(row, 0, n * sizeof(int));
+        for (int k = 0; k < n; k++) {
+            int a = A[(size_t)i * n + k];
+            const int *b_row = &B[(size_t)k * n];
+            for (int j = 0; j < n; j++) row[j] += a * b_row[j];
+        }
+        for (int j = 0; j < n; j++) sum += row[j];
+    }
+    free(row);
+    return sum;
+}
+
+void* client_main(void *arg) {
+    client_t *c = (client_t*)arg;
+    const load_config_t *cfg = c->cfg;
+
+    int fd = job_connect(job_socket_path());
+    if (fd < 0) {
+        c->errors = cfg->jobs_per_client;
+        return NULL;
+    }
+
+    for (int j = 0; j < cfg->jobs_per_client; j++) {
+        int s = (int)(rand_r(&c->rng) % cfg->num_sizes);
+        int n = cfg->sizes[s];
+        job_request_t req;
+        job_response_t resp;
+        job_request_init(&req, JOB_OP_MULTIPLY);
+        req.m = req.k = req.n = (uint32_t)n;
+        req.reply = JOB_REPLY_CHECKSUM;
+        req.seed_a = seed_a_for(n);
+        req.seed_b = seed_b_for(n);
+        req.source = cfg->inline_data ? JOB_SRC_INLINE : JOB_SRC_SEEDS;
+
+        double t0 = get_wall_time();
+        int ok = job_write_full(fd, &req, sizeof(req));
+        if (ok && cfg->inline_data) {
+            ok = job_write_full(fd, cfg->inputs_a[s], (size_t)n * n * sizeof(int)) &&
+                 job_write_full(fd, cfg->inputs_b[s], (size_t)n * n * sizeof(int));
+        }
+        ok = ok && job_read_full(fd, &resp, sizeof(resp)) && resp.magic == JOB_MAGIC;
+        double latency = get_wall_time() - t0;
+        if (!ok) {
+            c->errors += cfg->jobs_per_client - j;
+            break;
+        }
+        if (resp.status != JOB_OK) {
+            c->errors++;
+            continue;
+        }
+        if (resp.checksum != cfg->expected[s]) c->mismatches++;
+        c->latencies[c->completed++] = latency;
+    }
+
+    close(fd);
+    return NULL;
+}
+
+int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <clientes> <trabajos_por_cliente> <tamaños> [semillas|inline]\n", program_name);
+    printf("  clientes: Conexiones concurrentes, un hilo cada una (obligatorio)\n");
+    printf("  trabajos_por_cliente: Multiplicaciones que envía cada cliente (obligatorio)\n");
+    printf("  tamaños: Lista separada por comas; cada trabajo elige uno al azar (obligatorio)\n");
+    printf("  semillas: el servidor genera A y B; inline: se envían los datos (por defecto: semillas)\n");
+    printf("  Socket: $MATMUL_SOCKET (por defecto %s)\n", JOB_DEFAULT_SOCKET);
+    printf("\nEjemplo: %s 8 200 32,64,128,512\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    load_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+
+    if (argc < 4 || argc > 5) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    int num_clients = atoi(argv[1]);
+    cfg.jobs_per_client = atoi(argv[2]);
+    char *list = strdup(argv[3]);
+    for (char *tok = strtok(list, ","); tok != NULL && cfg.num_sizes < MAX_SIZES; tok = strtok(NULL, ",")) {
+        cfg.sizes[cfg.num_sizes] = atoi(tok);
+        if (cfg.sizes[cfg.num_sizes] <= 0 || cfg.sizes[cfg.num_sizes] > JOB_MAX_DIM) {
+            printf("Error: Los tamaños deben estar en [1, %d].\n", JOB_MAX_DIM);
+            return 1;
+        }
+        cfg.num_sizes++;
+    }
+    free(list);
+    if (argc == 5) {
+        if (strcmp(argv[4], "inline") == 0) cfg.inline_data = 1;
+        else if (strcmp(argv[4], "semillas") != 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (num_clients <= 0 || cfg.jobs_per_client <= 0 || cfg.num_sizes == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    for (int s = 0; s < cfg.num_sizes; s++) {
+        int n = cfg.sizes[s];
+        cfg.inputs_a[s] = generate_flat(n, seed_a_for(n));
+        cfg.inputs_b[s] = generate_flat(n, seed_b_for(n));
+        cfg.expected[s] = local_checksum(cfg.inputs_a[s], cfg.inputs_b[s], n);
+    }
+
+    client_t *clients = (client_t*)calloc(num_clients, sizeof(client_t));
+    pthread_t *threads = (pthread_t*)malloc(num_clients * sizeof(pthread_t));
+    for (int c = 0; c < num_clients; c++) {
+        clients[c].id = c;
+        clients[c].cfg = &cfg;
+        clients[c].rng = 1234u + (unsigned int)c;
+        clients[c].latencies = (double*)malloc(cfg.jobs_per_client * sizeof(double));
+    }
+
+    double wall_start = get_wall_time();
+    for (int c = 0; c < num_clients; c++) {
+        pthread_create(&threads[c], NULL, client_main, &clients[c]);
+    }
+    for (int c = 0; c < num_clients; c++) {
+        pthread_join(threads[c], NULL);
+    }
+    double wall = get_wall_time() - wall_start;
+
+    int total = 0, mismatches = 0, errors = 0;
+    for (int c = 0; c < num_clients; c++) {
+        total += clients[c].completed;
+        mismatches += clients[c].mismatches;
+        errors += clients[c].errors;
+    }
+    double *all = (double*)malloc((total > 0 ? total : 1) * sizeof(double));
+    double latency_sum = 0.0;
+    int idx = 0;
+    for (int c = 0; c < num_clients; c++) {
+        for (int j = 0; j < clients[c].completed; j++) {
+            all[idx++] = clients[c].latencies[j];
+            latency_sum += clients[c].latencies[j];
+        }
+    }
+    qsort(all, total, sizeof(double), compare_double);
+
+    printf("Clientes: %d, trabajos completados: %d, errores: %d\n", num_clients, total, errors);
+    if (total > 0) {
+        printf("Throughput: %.2f trabajos/s\n", total / wall);
+        printf("Latencia (cliente): media %.6f s, p50 %.6f s, p95 %.6f s, p99 %.6f s, máx %.6f s\n",
+               latency_sum / total, all[total / 2], all[(int)(total * 0.95)],
+               all[(int)(total * 0.99)], all[total - 1]);
+    }
+    if (mismatches == 0 && errors == 0) {
+        printf("✓ Verificación exitosa: todas las sumas coinciden con la referencia local\n");
+    } else {
+        printf("✗ Error: %d sumas distintas de la referencia, %d errores\n", mismatches, errors);
+    }
+    printf("Tiempo real (wall time): %.6f segundos\n", wall);
+
+    for (int c = 0; c < num_clients; c++) free(clients[c].latencies);
+    for (int s = 0; s < cfg.num_sizes; s++) {
+        free(cfg.inputs_a[s]);
+        free(cfg.inputs_b[s]);
+    }
+    free(clients);
+    free(threads);
+    free(all);
+    return (mismatches == 0 && errors == 0) ? 0 : 1;
+}
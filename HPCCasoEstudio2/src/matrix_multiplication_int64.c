@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define BLOCK_SIZE 32
+#define DEFAULT_MAX_VALUE 99
+
+// Modo de acumulación del micro-kernel
+typedef enum {
+    ACC_AUTO,
+    ACC_INT32,
+    ACC_INT64
+} acc_mode_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para inicializar una matriz con valores aleatorios en [0, max_value]
+void initialize_matrix(int **matrix, int size, int seed, int max_value) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % (max_value + 1);
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada de elementos de elem_size bytes
+void** allocate_matrix(int size, size_t elem_size) {
+    void **matrix = (void**)malloc(size * sizeof(void*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = malloc(size * elem_size);
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(void **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// Planificador: elige int32 si |C[i][j]| <= n * max|A| * max|B| cabe en int,
+// y int64 en caso contrario. Si ni siquiera int64 alcanza lo reporta con -1.
+acc_mode_t plan_accumulation(int size, int max_a, int max_b) {
+    __int128 bound = (__int128)size * max_a * max_b;
+    if (bound <= INT32_MAX) return ACC_INT32;
+    if (bound <= INT64_MAX) return ACC_INT64;
+    return (acc_mode_t)-1;
+}
+
+// Micro-kernel int32: c_row[j] += a * b_row[j] para j en [j0, j1)
+static inline void kernel_row_int32(int *c_row, const int *b_row, int a, int j0, int j1) {
+    #pragma omp simd
+    for (int j = j0; j < j1; j++) {
+        c_row[j] += a * b_row[j];
+    }
+}
+
+// Micro-kernel int64 con multiplicación ensanchada 32x32 -> 64.
+// Con AVX2 se usa vpmovsxdq + vpmuldq; en otro caso el compilador
+// vectoriza la conversión explícita a int64.
+static inline void kernel_row_int64(int64_t *c_row, const int *b_row, int a, int j0, int j1) {
+    int j = j0;
+#ifdef __AVX2__
+    __m256i va = _mm256_set1_epi64x((long long)a);
+    for (; j + 4 <= j1; j += 4) {
+        __m256i vb = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)&b_row[j]));
+        __m256i vc = _mm256_loadu_si256((const __m256i*)&c_row[j]);
+        vc = _mm256_add_epi64(vc, _mm256_mul_epi32(va, vb));
+        _mm256_storeu_si256((__m256i*)&c_row[j], vc);
+    }
+#endif
+    #pragma omp simd
+    for (int jj = j; jj < j1; jj++) {
+        c_row[jj] += (int64_t)a * (int64_t)b_row[jj];
+    }
+}
+
+// Multiplicación con blocking acumulando en int32
+void matrix_multiply_blocking_int32(int **A, int **B, int **C, int size) {
+    #pragma omp parallel for
+    for (int i = 0; i < size; i++) {
+        memset(C[i], 0, size * sizeof(int));
+    }
+    #pragma omp parallel for schedule(static)
+    for (int ii = 0; ii < size; ii += BLOCK_SIZE) {
+        int i_end = (ii + BLOCK_SIZE < size) ? ii + BLOCK_SIZE : size;
+        for (int kk = 0; kk < size; kk += BLOCK_SIZE) {
+            int k_end = (kk + BLOCK_SIZE < size) ? kk + BLOCK_SIZE : size;
+            for (int jj = 0; jj < size; jj += BLOCK_SIZE) {
+                int j_end = (jj + BLOCK_SIZE < size) ? jj + BLOCK_SIZE : size;
+                for (int i = ii; i < i_end; i++) {
+                    for (int k = kk; k < k_end; k++) {
+                        kernel_row_int32(C[i], B[k], A[i][k], jj, j_end);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Multiplicación con blocking acumulando en int64 (entradas int32)
+void matrix_multiply_blocking_int64(int **A, int **B, int64_t **C, int size) {
+    #pragma omp parallel for
+    for (int i = 0; i < size; i++) {
+        memset(C[i], 0, size * sizeof(int64_t));
+    }
+    #pragma omp parallel for schedule(static)
+    for (int ii = 0; ii < size; ii += BLOCK_SIZE) {
+        int i_end = (ii + BLOCK_SIZE < size) ? ii + BLOCK_SIZE : size;
+        for (int kk = 0; kk < size; kk += BLOCK_SIZE) {
+            int k_end = (kk + BLOCK_SIZE < size) ? kk + BLOCK_SIZE : size;
+            for (int jj = 0; jj < size; jj += BLOCK_SIZE) {
+                int j_end = (jj + BLOCK_SIZE < size) ? jj + BLOCK_SIZE : size;
+                for (int i = ii; i < i_end; i++) {
+                    for (int k = kk; k < k_end; k++) {
+                        kernel_row_int64(C[i], B[k], A[i][k], jj, j_end);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Verificación por muestreo: recalcula en int64 escalar una entrada por fila (O(n²))
+int verify_sampled(int **A, int **B, void **C, acc_mode_t mode, int size) {
+    for (int i = 0; i < size; i++) {
+        int j = (int)(((long long)i * 7919) % size);
+        int64_t expected = 0;
+        for (int k = 0; k < size; k++) {
+            expected += (int64_t)A[i][k] * B[k][j];
+        }
+        int64_t got = (mode == ACC_INT64) ? ((int64_t**)C)[i][j] : ((int**)C)[i][j];
+        if (got != expected) {
+            printf("✗ Error: C[%d][%d]=%lld != %lld (desbordamiento)\n",
+                   i, j, (long long)got, (long long)expected);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Escribe en buf el valor decimal exacto de un entero de 128 bits
+void format_int128(__int128 value, char *buf) {
+    char digits[48];
+    int len = 0, neg = value < 0;
+    unsigned __int128 u = neg ? -(unsigned __int128)value : (unsigned __int128)value;
+    do {
+        digits[len++] = (char)('0' + (int)(u % 10));
+        u /= 10;
+    } while (u != 0);
+    if (neg) *buf++ = '-';
+    while (len > 0) *buf++ = digits[--len];
+    *buf = '\0';
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [semilla_A] [semilla_B] [modo] [valor_max]\n", program_name);
+    printf("  tamaño_matriz: Tamaño de las matrices cuadradas (obligatorio)\n");
+    printf("  semilla_A: Semilla para generar matriz A (opcional, por defecto: tiempo actual)\n");
+    printf("  semilla_B: Semilla para generar matriz B (opcional, por defecto: tiempo actual + 1)\n");
+    printf("  modo: auto, int32 o int64 (opcional, por defecto: auto)\n");
+    printf("  valor_max: Cota superior de los valores generados (opcional, por defecto: %d)\n",
+           DEFAULT_MAX_VALUE);
+    printf("\nEjemplo: %s 512 123 456 auto 99\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int seed_A, seed_B;
+    int max_value = DEFAULT_MAX_VALUE;
+    acc_mode_t requested = ACC_AUTO, mode;
+    double start_time, end_time, wall_start, wall_end;
+
+    if (argc < 2 || argc > 6) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    seed_A = (argc >= 3) ? atoi(argv[2]) : (int)time(NULL);
+    seed_B = (argc >= 4) ? atoi(argv[3]) : seed_A + 1;
+    if (argc >= 5) {
+        if (strcmp(argv[4], "int32") == 0) requested = ACC_INT32;
+        else if (strcmp(argv[4], "int64") == 0) requested = ACC_INT64;
+        else if (strcmp(argv[4], "auto") != 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc == 6) {
+        max_value = atoi(argv[5]);
+        if (max_value <= 0 || max_value >= RAND_MAX) {
+            printf("Error: valor_max fuera de rango.\n");
+            return 1;
+        }
+    }
+
+    acc_mode_t planned = plan_accumulation(size, max_value, max_value);
+    if ((int)planned < 0) {
+        printf("Error: ni int64 alcanza para n=%d y valor_max=%d.\n", size, max_value);
+        return 1;
+    }
+    mode = (requested == ACC_AUTO) ? planned : requested;
+    printf("Acumulación: %s (planificador: %s, cota |C| = %lld)\n",
+           mode == ACC_INT64 ? "int64" : "int32",
+           planned == ACC_INT64 ? "int64" : "int32",
+           (long long)size * max_value * max_value);
+    if (mode == ACC_INT32 && planned == ACC_INT64) {
+        printf("Advertencia: int32 forzado, el resultado puede desbordar.\n");
+    }
+
+    int **A = (int**)allocate_matrix(size, sizeof(int));
+    int **B = (int**)allocate_matrix(size, sizeof(int));
+    void **C = allocate_matrix(size, mode == ACC_INT64 ? sizeof(int64_t) : sizeof(int));
+
+    initialize_matrix(A, size, seed_A, max_value);
+    initialize_matrix(B, size, seed_B, max_value);
+
+    start_time = get_user_time();
+    wall_start = get_wall_time();
+    if (mode == ACC_INT64) {
+        matrix_multiply_blocking_int64(A, B, (int64_t**)C, size);
+    } else {
+        matrix_multiply_blocking_int32(A, B, (int**)C, size);
+    }
+    wall_end = get_wall_time();
+    end_time = get_user_time();
+
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+
+    int ok = verify_sampled(A, B, C, mode, size);
+    if (ok) {
+        printf("✓ Verificación por muestreo exitosa\n");
+    }
+
+    // Suma de verificación en 128 bits: n² entradas de hasta n·max² desbordan
+    // long long aunque cada C[i][j] quepa en int64
+    __int128 sum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += (mode == ACC_INT64) ? ((int64_t**)C)[i][j] : ((int**)C)[i][j];
+        }
+    }
+    char sum_text[48];
+    format_int128(sum, sum_text);
+    printf("Suma de verificación de la matriz resultado: %s\n", sum_text);
+
+    free_matrix((void**)A, size);
+    free_matrix((void**)B, size);
+    free_matrix(C, size);
+
+    return ok ? 0 : 1;
+}
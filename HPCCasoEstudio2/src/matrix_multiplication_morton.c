@@ -0,0 +1,385 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// Tile de 32x32 int = 4 KB: cada tile ocupa exactamente una página
+#define TILE 32
+#define TILE_ELEMS (TILE * TILE)
+#define BLOCK_SIZE 32
+// Por debajo de este número de tiles por lado la recursión deja de crear tareas
+#define TASK_CUTOFF_TILES 4
+
+// Matriz en layout Z-order por tiles: tiles de TILE x TILE contiguos (row-major
+// dentro del tile) y los tiles ordenados por su índice de Morton.
+// Los tiles por lado se redondean a potencia de 2, así que la memoria reservada
+// puede ser hasta ~4 veces la de n x n (n justo por encima de 2^k * TILE); main
+// imprime cuánto es relleno.
+typedef struct {
+    int *data;
+    int size;      // Tamaño lógico n
+    int tiles;     // Tiles por lado (potencia de 2)
+    int used;      // Tiles por lado con datos (ceil(n / TILE)); el resto es relleno
+} morton_matrix_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para inicializar una matriz con valores aleatorios
+void initialize_matrix(int **matrix, int size, int seed) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 100;
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// Separa los bits de x dejando un cero entre cada uno (x < 2^16)
+static inline uint32_t spread_bits(uint32_t x) {
+    x &= 0x0000ffff;
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+// Índice de Morton del tile (fila, columna); el bit de fila va en la posición alta,
+// así los cuadrantes quedan en orden 0=NO, 1=NE, 2=SO, 3=SE
+static inline uint32_t morton_index(int tile_row, int tile_col) {
+    return (spread_bits((uint32_t)tile_row) << 1) | spread_bits((uint32_t)tile_col);
+}
+
+// Inversa de morton_index: (fila, columna) del tile con índice t
+static inline void morton_decode(uint32_t t, int *tile_row, int *tile_col) {
+    int tr = 0, tc = 0;
+    for (int b = 0; b < 16; b++) {
+        tc |= ((t >> (2 * b)) & 1) << b;
+        tr |= ((t >> (2 * b + 1)) & 1) << b;
+    }
+    *tile_row = tr;
+    *tile_col = tc;
+}
+
+static inline int* morton_tile(const morton_matrix_t *m, int tile_row, int tile_col) {
+    return m->data + (size_t)morton_index(tile_row, tile_col) * TILE_ELEMS;
+}
+
+int morton_alloc(morton_matrix_t *m, int size) {
+    int tiles = 1;
+    while (tiles * TILE < size) tiles <<= 1;
+    m->size = size;
+    m->tiles = tiles;
+    m->used = (size + TILE - 1) / TILE;
+    // Alineado a página para que cada tile caiga en una sola página
+    size_t bytes = (size_t)tiles * tiles * TILE_ELEMS * sizeof(int);
+    if (posix_memalign((void**)&m->data, 4096, bytes) != 0) return 0;
+    memset(m->data, 0, bytes);
+    return 1;
+}
+
+void morton_free(morton_matrix_t *m) {
+    free(m->data);
+}
+
+// Conversión row-major (int**) -> Z-order; el relleno queda en cero
+void morton_from_rowmajor(morton_matrix_t *m, int **src) {
+    int size = m->size;
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int tr = 0; tr < m->tiles; tr++) {
+        for (int tc = 0; tc < m->tiles; tc++) {
+            int *tile = morton_tile(m, tr, tc);
+            int i0 = tr * TILE, j0 = tc * TILE;
+            if (i0 >= size || j0 >= size) continue;
+            int rows = (size - i0 < TILE) ? size - i0 : TILE;
+            int cols = (size - j0 < TILE) ? size - j0 : TILE;
+            for (int i = 0; i < rows; i++) {
+                memcpy(&tile[i * TILE], &src[i0 + i][j0], cols * sizeof(int));
+            }
+        }
+    }
+}
+
+// Conversión Z-order -> row-major (int**)
+void morton_to_rowmajor(const morton_matrix_t *m, int **dst) {
+    int size = m->size;
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (int tr = 0; tr < m->tiles; tr++) {
+        for (int tc = 0; tc < m->tiles; tc++) {
+            const int *tile = morton_tile(m, tr, tc);
+            int i0 = tr * TILE, j0 = tc * TILE;
+            if (i0 >= size || j0 >= size) continue;
+            int rows = (size - i0 < TILE) ? size - i0 : TILE;
+            int cols = (size - j0 < TILE) ? size - j0 : TILE;
+            for (int i = 0; i < rows; i++) {
+                memcpy(&dst[i0 + i][j0], &tile[i * TILE], cols * sizeof(int));
+            }
+        }
+    }
+}
+
+// Kernel de tile: C_t += A_t * B_t con los tres tiles contiguos
+static inline void tile_multiply_add(const int *restrict A, const int *restrict B, int *restrict C) {
+    for (int i = 0; i < TILE; i++) {
+        int *c_row = &C[i * TILE];
+        for (int k = 0; k < TILE; k++) {
+            int a = A[i * TILE + k];
+            const int *b_row = &B[k * TILE];
+            #pragma omp simd
+            for (int j = 0; j < TILE; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+// Variante por bloques: recorre los tiles de C en orden de Morton. Primero se
+// listan los tiles con datos (en orden de Morton) y el reparto estático se hace
+// sobre esa lista: con n apenas por encima de una potencia de 2 solo ~1/4 de los
+// índices son trabajo real y están todos al principio del rango, así que
+// repartir los índices rellenos dejaría a la mayoría de los hilos sin nada.
+void matrix_multiply_morton_blocked(const morton_matrix_t *A, const morton_matrix_t *B,
+                                    morton_matrix_t *C) {
+    int tiles = C->tiles;
+    int used = C->used;
+    int total = tiles * tiles;
+    int num_work = 0;
+    int *work = (int*)malloc((size_t)used * used * sizeof(int));
+    for (int t = 0; t < total; t++) {
+        int tr, tc;
+        morton_decode((uint32_t)t, &tr, &tc);
+        if (tr < used && tc < used) work[num_work++] = t;
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (int w = 0; w < num_work; w++) {
+        int t = work[w];
+        int tr, tc;
+        morton_decode((uint32_t)t, &tr, &tc);
+        // Los tiles de relleno de C no se leen: solo se ponen a cero los usados
+        int *c_tile = C->data + (size_t)t * TILE_ELEMS;
+        memset(c_tile, 0, TILE_ELEMS * sizeof(int));
+        for (int tk = 0; tk < used; tk++) {
+            tile_multiply_add(morton_tile(A, tr, tk), morton_tile(B, tk, tc), c_tile);
+        }
+    }
+    free(work);
+}
+
+// Variante recursiva: en Z-order cada cuadrante de una submatriz es un cuarto
+// contiguo de su memoria, así que la recursión solo desplaza punteros.
+// (r0, c0, k0) es el tile de origen de C, B y A; los subproblemas que caen
+// completamente en el relleno se descartan.
+static void morton_recursive(const int *A, const int *B, int *C, int tiles,
+                             int r0, int c0, int k0, int used) {
+    if (r0 >= used || c0 >= used || k0 >= used) return;
+    if (tiles == 1) {
+        tile_multiply_add(A, B, C);
+        return;
+    }
+    int half = tiles / 2;
+    size_t q = (size_t)half * half * TILE_ELEMS;
+    const int *A0 = A, *A1 = A + q, *A2 = A + 2 * q, *A3 = A + 3 * q;
+    const int *B0 = B, *B1 = B + q, *B2 = B + 2 * q, *B3 = B + 3 * q;
+
+    // Cada tarea escribe un cuadrante distinto de C: no hay carreras
+    #pragma omp task if(tiles > TASK_CUTOFF_TILES)
+    {
+        morton_recursive(A0, B0, C, half, r0, c0, k0, used);
+        morton_recursive(A1, B2, C, half, r0, c0, k0 + half, used);
+    }
+    #pragma omp task if(tiles > TASK_CUTOFF_TILES)
+    {
+        morton_recursive(A0, B1, C + q, half, r0, c0 + half, k0, used);
+        morton_recursive(A1, B3, C + q, half, r0, c0 + half, k0 + half, used);
+    }
+    #pragma omp task if(tiles > TASK_CUTOFF_TILES)
+    {
+        morton_recursive(A2, B0, C + 2 * q, half, r0 + half, c0, k0, used);
+        morton_recursive(A3, B2, C + 2 * q, half, r0 + half, c0, k0 + half, used);
+    }
+    #pragma omp task if(tiles > TASK_CUTOFF_TILES)
+    {
+        morton_recursive(A2, B1, C + 3 * q, half, r0 + half, c0 + half, k0, used);
+        morton_recursive(A3, B3, C + 3 * q, half, r0 + half, c0 + half, k0 + half, used);
+    }
+    #pragma omp taskwait
+}
+
+void matrix_multiply_morton_recursive(const morton_matrix_t *A, const morton_matrix_t *B,
+                                      morton_matrix_t *C) {
+    memset(C->data, 0, (size_t)C->tiles * C->tiles * TILE_ELEMS * sizeof(int));
+    #pragma omp parallel
+    #pragma omp single
+    morton_recursive(A->data, B->data, C->data, C->tiles, 0, 0, 0, C->used);
+}
+
+// Referencia row-major con blocking (mismo recorrido que matrix_multiplication_blocking.c)
+void matrix_multiply_blocking(int **A, int **B, int **C, int size) {
+    int i, j, k, ii, jj, kk;
+    #pragma omp parallel for private(j)
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) {
+            C[i][j] = 0;
+        }
+    }
+    #pragma omp parallel for collapse(2) private(i, j, k, kk)
+    for (ii = 0; ii < size; ii += BLOCK_SIZE) {
+        for (jj = 0; jj < size; jj += BLOCK_SIZE) {
+            for (kk = 0; kk < size; kk += BLOCK_SIZE) {
+                for (i = ii; i < ii + BLOCK_SIZE && i < size; i++) {
+                    for (j = jj; j < jj + BLOCK_SIZE && j < size; j++) {
+                        int sum = C[i][j];
+                        for (k = kk; k < kk + BLOCK_SIZE && k < size; k++) {
+                            sum += A[i][k] * B[k][j];
+                        }
+                        C[i][j] = sum;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int compare_matrices(int **X, int **Y, int size) {
+    for (int i = 0; i < size; i++) {
+        if (memcmp(X[i], Y[i], size * sizeof(int)) != 0) return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int seed_A, seed_B;
+    double start_time, end_time, wall_start, wall_end;
+
+    if (argc < 2 || argc > 4) {
+        printf("Uso: %s <tamaño_matriz> [semilla_A] [semilla_B]\n", argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0 || size > TILE * 65536) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    seed_A = (argc >= 3) ? atoi(argv[2]) : (int)time(NULL);
+    seed_B = (argc == 4) ? atoi(argv[3]) : seed_A + 1;
+
+    int **A = allocate_matrix(size);
+    int **B = allocate_matrix(size);
+    int **C = allocate_matrix(size);
+    int **C_rowmajor = allocate_matrix(size);
+
+    initialize_matrix(A, size, seed_A);
+    initialize_matrix(B, size, seed_B);
+
+    morton_matrix_t Am, Bm, Cm;
+    if (!morton_alloc(&Am, size) || !morton_alloc(&Bm, size) || !morton_alloc(&Cm, size)) {
+        printf("Error: No se pudo alocar memoria para las matrices Z-order.\n");
+        return 1;
+    }
+
+    // Línea base row-major
+    wall_start = get_wall_time();
+    matrix_multiply_blocking(A, B, C_rowmajor, size);
+    double rowmajor_wall = get_wall_time() - wall_start;
+
+    // Conversión a Z-order (se reporta aparte)
+    wall_start = get_wall_time();
+    morton_from_rowmajor(&Am, A);
+    morton_from_rowmajor(&Bm, B);
+    double convert_in_wall = get_wall_time() - wall_start;
+
+    // Variante recursiva
+    wall_start = get_wall_time();
+    matrix_multiply_morton_recursive(&Am, &Bm, &Cm);
+    double recursive_wall = get_wall_time() - wall_start;
+    morton_to_rowmajor(&Cm, C);
+    int recursive_ok = compare_matrices(C, C_rowmajor, size);
+
+    // Variante por bloques en orden de Morton (la que se reporta como tiempo principal)
+    start_time = get_user_time();
+    wall_start = get_wall_time();
+    matrix_multiply_morton_blocked(&Am, &Bm, &Cm);
+    wall_end = get_wall_time();
+    end_time = get_user_time();
+
+    double convert_out_start = get_wall_time();
+    morton_to_rowmajor(&Cm, C);
+    double convert_out_wall = get_wall_time() - convert_out_start;
+    int blocked_ok = compare_matrices(C, C_rowmajor, size);
+
+    printf("Layout Z-order: %d x %d tiles de %dx%d (relleno a %d)\n",
+           Am.tiles, Am.tiles, TILE, TILE, Am.tiles * TILE);
+    printf("Memoria Z-order: %.1f MB por matriz, %.1f%% relleno\n",
+           (double)Am.tiles * Am.tiles * TILE_ELEMS * sizeof(int) / (1 << 20),
+           100.0 * (1.0 - (double)size * size / ((double)Am.tiles * Am.tiles * TILE_ELEMS)));
+    printf("Blocking row-major: %.6f segundos\n", rowmajor_wall);
+    printf("Z-order recursivo: %.6f segundos (speedup %.2fx)\n",
+           recursive_wall, rowmajor_wall / recursive_wall);
+    printf("Z-order por bloques: %.6f segundos (speedup %.2fx)\n",
+           wall_end - wall_start, rowmajor_wall / (wall_end - wall_start));
+    printf("Conversión a Z-order (A y B): %.6f segundos, de vuelta (C): %.6f segundos\n",
+           convert_in_wall, convert_out_wall);
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+
+    if (recursive_ok && blocked_ok) {
+        printf("✓ Verificación exitosa: Z-order coincide con row-major\n");
+    } else {
+        printf("✗ Error: recursivo %s, por bloques %s\n",
+               recursive_ok ? "ok" : "distinto", blocked_ok ? "ok" : "distinto");
+    }
+
+    // Calcular suma de verificación
+    long long sum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += C[i][j];
+        }
+    }
+    printf("Suma de verificación de la matriz resultado: %lld\n", sum);
+
+    morton_free(&Am);
+    morton_free(&Bm);
+    morton_free(&Cm);
+    free_matrix(A, size);
+    free_matrix(B, size);
+    free_matrix(C, size);
+    free_matrix(C_rowmajor, size);
+
+    return 0;
+}
@@ -6,12 +6,11 @@
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <omp.h>
+#include "phase_timer.h"
 
-// Función para obtener tiempo real (wall time) en segundos
+// Función para obtener tiempo real (wall time) en segundos, con reloj monotónico
 double get_wall_time() {
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+    return pt_now();
 }
 
 // Función para obtener tiempo de usuario en segundos
@@ -78,18 +77,27 @@ int main(int argc, char *argv[]) {
     seed_A = (argc >= 3) ? atoi(argv[2]) : (int)time(NULL);
     seed_B = (argc == 4) ? atoi(argv[3]) : seed_A + 1;
 
+    pt_run_t run;
+    pt_init(&run, "matrix_multiplication_parallel");
+    pt_param(&run, "n", size);
+    pt_param(&run, "threads", omp_get_max_threads());
+
+    pt_begin(&run, "alloc");
     int **A = allocate_matrix(size);
     int **B = allocate_matrix(size);
     int **C = allocate_matrix(size);
 
+    pt_begin(&run, "init");
     initialize_matrix(A, size, seed_A);
     initialize_matrix(B, size, seed_B);
 
+    pt_begin(&run, "compute");
     start_time = get_user_time();
     wall_start = get_wall_time();
     matrix_multiply_parallel(A, B, C, size);
     wall_end = get_wall_time();
     end_time = get_user_time();
+    pt_end(&run);
 
     cpu_time_used = end_time - start_time;
     wall_time_used = wall_end - wall_start;
@@ -97,6 +105,7 @@ int main(int argc, char *argv[]) {
     printf("Tiempo real (wall time): %.6f segundos\n", wall_time_used);
 
     // Calcular suma de verificación
+    pt_begin(&run, "verify");
     long long sum = 0;
     for (int i = 0; i < size; i++) {
         for (int j = 0; j < size; j++) {
@@ -105,9 +114,11 @@ int main(int argc, char *argv[]) {
     }
     printf("Suma de verificación de la matriz resultado: %lld\n", sum);
 
+    pt_begin(&run, "teardown");
     free_matrix(A, size);
     free_matrix(B, size);
     free_matrix(C, size);
+    pt_emit(&run);
 
     return 0;
 }
\ No newline at end of file
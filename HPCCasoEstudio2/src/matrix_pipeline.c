@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <omp.h>
+
+#define BLOCK_SIZE 32
+#define NUM_STAGES 3
+
+enum { STAGE_INIT = 0, STAGE_MULTIPLY, STAGE_VERIFY };
+static const char *stage_names[NUM_STAGES] = {"generación", "multiplicación", "verificación"};
+
+// Intervalos [inicio, fin] de cada etapa por panel, en segundos desde t0
+typedef struct {
+    int panels;
+    double *start[NUM_STAGES];
+    double *end[NUM_STAGES];
+} stage_trace_t;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para inicializar filas [row_begin, row_end) de una matriz. Continúa la
+// secuencia de rand(): llamada por paneles en orden produce la misma matriz que
+// initialize_matrix de una sola vez (el srand(seed) lo hace el llamador).
+void initialize_rows(int **matrix, int size, int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 100;
+        }
+    }
+}
+
+// Función para inicializar una matriz con valores aleatorios
+void initialize_matrix(int **matrix, int size, int seed) {
+    srand(seed);
+    initialize_rows(matrix, size, 0, size);
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Llena la matriz con -1: toca todas las páginas (sin fallos de primer acceso en
+// la medición) y deja valores que ninguna etapa produce, para que un panel
+// leído antes de generarse cambie la suma
+void poison_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        memset(matrix[i], 0xff, size * sizeof(int));
+    }
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// C[row_begin:row_end) = A[row_begin:row_end) * B, con bloques de k y j (i-k-j)
+void multiply_panel(int **A, int **B, int **C, int size, int row_begin, int row_end) {
+    for (int i = row_begin; i < row_end; i++) {
+        memset(C[i], 0, size * sizeof(int));
+    }
+    for (int kk = 0; kk < size; kk += BLOCK_SIZE) {
+        int k_end = (kk + BLOCK_SIZE < size) ? kk + BLOCK_SIZE : size;
+        for (int jj = 0; jj < size; jj += BLOCK_SIZE) {
+            int j_end = (jj + BLOCK_SIZE < size) ? jj + BLOCK_SIZE : size;
+            for (int i = row_begin; i < row_end; i++) {
+                int *c_row = C[i];
+                for (int k = kk; k < k_end; k++) {
+                    int a = A[i][k];
+                    int *b_row = B[k];
+                    for (int j = jj; j < j_end; j++) {
+                        c_row[j] += a * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+long long checksum_rows(int **C, int size, int row_begin, int row_end) {
+    long long sum = 0;
+    for (int i = row_begin; i < row_end; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += C[i][j];
+        }
+    }
+    return sum;
+}
+
+// Tres pasadas completas (generar A, multiplicar, sumar), como el resto de CE2;
+// dentro de cada pasada los paneles se reparten entre hilos
+long long run_phased(int **A, int **B, int **C, int size, int panel, int seed_A, double phase_wall[NUM_STAGES]) {
+    long long sum = 0;
+    int panels = (size + panel - 1) / panel;
+    double t = omp_get_wtime();
+
+    initialize_matrix(A, size, seed_A);
+    phase_wall[STAGE_INIT] = omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int p = 0; p < panels; p++) {
+        int r1 = (p + 1) * panel < size ? (p + 1) * panel : size;
+        multiply_panel(A, B, C, size, p * panel, r1);
+    }
+    phase_wall[STAGE_MULTIPLY] = omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    #pragma omp parallel for reduction(+:sum) schedule(static)
+    for (int p = 0; p < panels; p++) {
+        int r1 = (p + 1) * panel < size ? (p + 1) * panel : size;
+        sum += checksum_rows(C, size, p * panel, r1);
+    }
+    phase_wall[STAGE_VERIFY] = omp_get_wtime() - t;
+    return sum;
+}
+
+// Pipeline por paneles de filas de A con tareas OpenMP:
+//   generar(p)     en cadena (comparte el estado de rand()), depende de generar(p-1)
+//   multiplicar(p) depende de generar(p)
+//   verificar(p)   depende de multiplicar(p)
+// Mientras un hilo genera el panel p+1 otros multiplican p y suman p-1, y cada
+// panel de A y de C se usa recién escrito, todavía en caché.
+long long run_pipelined(int **A, int **B, int **C, int size, int panel, int seed_A, stage_trace_t *trace) {
+    int panels = trace->panels;
+    long long *panel_sum = (long long*)calloc(panels, sizeof(long long));
+    char *gen_done = (char*)calloc(panels, 1);
+    char *mul_done = (char*)calloc(panels, 1);
+    char rand_state = 0;        // Solo es el token de dependencia de la cadena de generación
+    double t0 = omp_get_wtime();
+
+    (void)rand_state;
+    srand(seed_A);
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (int p = 0; p < panels; p++) {
+            int r0 = p * panel;
+            int r1 = (r0 + panel < size) ? r0 + panel : size;
+
+            #pragma omp task firstprivate(p, r0, r1) depend(inout: rand_state) depend(out: gen_done[p])
+            {
+                trace->start[STAGE_INIT][p] = omp_get_wtime() - t0;
+                initialize_rows(A, size, r0, r1);
+                trace->end[STAGE_INIT][p] = omp_get_wtime() - t0;
+            }
+            #pragma omp task firstprivate(p, r0, r1) depend(in: gen_done[p]) depend(out: mul_done[p])
+            {
+                trace->start[STAGE_MULTIPLY][p] = omp_get_wtime() - t0;
+                multiply_panel(A, B, C, size, r0, r1);
+                trace->end[STAGE_MULTIPLY][p] = omp_get_wtime() - t0;
+            }
+            #pragma omp task firstprivate(p, r0, r1) depend(in: mul_done[p])
+            {
+                trace->start[STAGE_VERIFY][p] = omp_get_wtime() - t0;
+                panel_sum[p] = checksum_rows(C, size, r0, r1);
+                trace->end[STAGE_VERIFY][p] = omp_get_wtime() - t0;
+            }
+        }
+    }
+
+    long long sum = 0;
+    for (int p = 0; p < panels; p++) sum += panel_sum[p];
+    free(panel_sum);
+    free(gen_done);
+    free(mul_done);
+    return sum;
+}
+
+typedef struct {
+    double time;
+    int stage;
+    int delta;   // +1 inicio, -1 fin
+} stage_event_t;
+
+int compare_events(const void *a, const void *b) {
+    const stage_event_t *x = (const stage_event_t*)a, *y = (const stage_event_t*)b;
+    if (x->time < y->time) return -1;
+    if (x->time > y->time) return 1;
+    return x->delta - y->delta;   // Fines antes que inicios en el mismo instante
+}
+
+// Recorre los intervalos en orden temporal y acumula, por etapa, el tiempo con
+// al menos un panel activo y, en total, el tiempo con dos o más etapas distintas activas
+void report_overlap(const stage_trace_t *trace, double wall) {
+    int num_events = 2 * NUM_STAGES * trace->panels;
+    stage_event_t *events = (stage_event_t*)malloc(num_events * sizeof(stage_event_t));
+    double busy[NUM_STAGES] = {0}, active_time[NUM_STAGES] = {0};
+    int active[NUM_STAGES] = {0};
+    int e = 0;
+
+    for (int s = 0; s < NUM_STAGES; s++) {
+        for (int p = 0; p < trace->panels; p++) {
+            busy[s] += trace->end[s][p] - trace->start[s][p];
+            events[e++] = (stage_event_t){trace->start[s][p], s, +1};
+            events[e++] = (stage_event_t){trace->end[s][p], s, -1};
+        }
+    }
+    qsort(events, num_events, sizeof(stage_event_t), compare_events);
+
+    double overlapped = 0.0, prev = 0.0;
+    for (e = 0; e < num_events; e++) {
+        double span = events[e].time - prev;
+        int kinds = 0;
+        for (int s = 0; s < NUM_STAGES; s++) {
+            if (active[s] > 0) {
+                kinds++;
+                active_time[s] += span;
+            }
+        }
+        if (kinds >= 2) overlapped += span;
+        active[events[e].stage] += events[e].delta;
+        prev = events[e].time;
+    }
+
+    printf("Etapas del pipeline (%d paneles):\n", trace->panels);
+    for (int s = 0; s < NUM_STAGES; s++) {
+        printf("  %-15s ocupado %.6f s, activo %.6f s\n", stage_names[s], busy[s], active_time[s]);
+    }
+    printf("Tiempo con etapas superpuestas: %.6f segundos (%.1f%% del wall)\n",
+           overlapped, wall > 0 ? 100.0 * overlapped / wall : 0.0);
+    free(events);
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [filas_panel] [semilla_A] [semilla_B]\n", program_name);
+    printf("  tamaño_matriz: Tamaño de las matrices cuadradas (obligatorio)\n");
+    printf("  filas_panel: Filas de A por panel del pipeline (opcional, por defecto: %d)\n", BLOCK_SIZE);
+    printf("  semilla_A: Semilla para generar matriz A (opcional, por defecto: tiempo actual)\n");
+    printf("  semilla_B: Semilla para generar matriz B (opcional, por defecto: tiempo actual + 1)\n");
+    printf("\nEjemplo: %s 2048 64 123 456\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int panel = BLOCK_SIZE;
+    int seed_A, seed_B;
+    double start_time, end_time, wall_start, wall_end;
+
+    if (argc < 2 || argc > 5) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    if (argc >= 3) panel = atoi(argv[2]);
+    if (panel <= 0) {
+        printf("Error: Las filas por panel deben ser un número positivo.\n");
+        return 1;
+    }
+    seed_A = (argc >= 4) ? atoi(argv[3]) : (int)time(NULL);
+    seed_B = (argc == 5) ? atoi(argv[4]) : seed_A + 1;
+
+    int **A = allocate_matrix(size);
+    int **B = allocate_matrix(size);
+    int **C = allocate_matrix(size);
+    // El pipeline usa su propia A y C: si reusara las de las tres pasadas, A ya
+    // tendría los valores correctos y una dependencia generar->multiplicar
+    // faltante no cambiaría la suma
+    int **A_pipe = allocate_matrix(size);
+    int **C_pipe = allocate_matrix(size);
+
+    // B se necesita completa para cualquier panel: se genera antes en ambos modos
+    initialize_matrix(B, size, seed_B);
+    // Ambos modos empiezan con A y C envenenadas y ya mapeadas
+    poison_matrix(A, size);
+    poison_matrix(C, size);
+    poison_matrix(A_pipe, size);
+    poison_matrix(C_pipe, size);
+
+    double phase_wall[NUM_STAGES];
+    wall_start = get_wall_time();
+    long long phased_sum = run_phased(A, B, C, size, panel, seed_A, phase_wall);
+    double phased_wall = get_wall_time() - wall_start;
+    printf("Tres pasadas: %.6f segundos (generación %.6f, multiplicación %.6f, verificación %.6f)\n",
+           phased_wall, phase_wall[STAGE_INIT], phase_wall[STAGE_MULTIPLY], phase_wall[STAGE_VERIFY]);
+
+    stage_trace_t trace;
+    trace.panels = (size + panel - 1) / panel;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        trace.start[s] = (double*)calloc(trace.panels, sizeof(double));
+        trace.end[s] = (double*)calloc(trace.panels, sizeof(double));
+    }
+
+    start_time = get_user_time();
+    wall_start = get_wall_time();
+    long long sum = run_pipelined(A_pipe, B, C_pipe, size, panel, seed_A, &trace);
+    wall_end = get_wall_time();
+    end_time = get_user_time();
+
+    report_overlap(&trace, wall_end - wall_start);
+    printf("Speedup del pipeline vs tres pasadas: %.2fx\n", phased_wall / (wall_end - wall_start));
+
+    int correct = (sum == phased_sum);
+    if (correct) {
+        printf("✓ Verificación exitosa: el pipeline coincide con la ejecución en tres pasadas\n");
+    } else {
+        printf("✗ Error: suma del pipeline %lld, tres pasadas %lld\n", sum, phased_sum);
+    }
+
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+    printf("Suma de verificación de la matriz resultado: %lld\n", sum);
+
+    for (int s = 0; s < NUM_STAGES; s++) {
+        free(trace.start[s]);
+        free(trace.end[s]);
+    }
+    free_matrix(A, size);
+    free_matrix(B, size);
+    free_matrix(C, size);
+    free_matrix(A_pipe, size);
+    free_matrix(C_pipe, size);
+
+    return correct ? 0 : 1;
+}
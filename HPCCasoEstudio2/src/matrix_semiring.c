@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <limits.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// "Infinito" de los semianillos tropicales: la mitad del rango para que
+// INF + INF no desborde; min(INF, x + INF) sigue siendo INF
+#define SR_INF (INT_MAX / 2)
+#define VERIFY_ROWS 16
+#define APSP_SOURCES 16
+
+// Instancias del GEMM genérico (ver semiring_gemm.h)
+#define SR_NAME plus_times
+#define SR_ZERO 0
+#define SR_ADD(x, y) ((x) + (y))
+#define SR_MUL(x, y) ((x) * (y))
+#include "semiring_gemm.h"
+
+#define SR_NAME min_plus
+#define SR_ZERO SR_INF
+#define SR_ADD(x, y) ((x) < (y) ? (x) : (y))
+#define SR_MUL(x, y) ((x) + (y))
+#include "semiring_gemm.h"
+
+#define SR_NAME max_plus
+#define SR_ZERO (-SR_INF)
+#define SR_ADD(x, y) ((x) > (y) ? (x) : (y))
+#define SR_MUL(x, y) ((x) + (y))
+#include "semiring_gemm.h"
+
+#define SR_NAME or_and
+#define SR_ZERO 0
+#define SR_ADD(x, y) ((x) | (y))
+#define SR_MUL(x, y) ((x) & (y))
+#include "semiring_gemm.h"
+
+typedef struct {
+    const char *name;
+    void (*gemm)(int **A, int **B, int **C, int n);
+    void (*row_ref)(const int *a_row, int **B, int *c_row, int n);
+    int modulus;             // Valores de entrada en [0, modulus)
+} semiring_t;
+
+static const semiring_t semirings[] = {
+    {"plus_times", gemm_plus_times, gemm_row_ref_plus_times, 100},
+    {"min_plus",   gemm_min_plus,   gemm_row_ref_min_plus,   100},
+    {"max_plus",   gemm_max_plus,   gemm_row_ref_max_plus,   100},
+    {"or_and",     gemm_or_and,     gemm_row_ref_or_and,     2},
+};
+#define NUM_SEMIRINGS (int)(sizeof(semirings) / sizeof(semirings[0]))
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para obtener tiempo de usuario en segundos
+double get_user_time() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+}
+
+// Función para inicializar una matriz con valores aleatorios en [0, modulus)
+void initialize_matrix(int **matrix, int size, int seed, int modulus) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % modulus;
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+long long checksum(int **C, int size) {
+    long long sum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += C[i][j];
+        }
+    }
+    return sum;
+}
+
+// Compara filas muestreadas de C con la versión escalar del mismo semianillo
+int verify_rows(const semiring_t *sr, int **A, int **B, int **C, int size) {
+    int rows = (size < VERIFY_ROWS) ? size : VERIFY_ROWS;
+    int *expected = (int*)malloc(size * sizeof(int));
+    int ok = 1;
+    for (int r = 0; r < rows && ok; r++) {
+        int i = (int)(((long long)r * size) / rows);
+        sr->row_ref(A[i], B, expected, size);
+        if (memcmp(expected, C[i], size * sizeof(int)) != 0) {
+            printf("✗ %s: la fila %d no coincide con la referencia escalar\n", sr->name, i);
+            ok = 0;
+        }
+    }
+    free(expected);
+    return ok;
+}
+
+// Corre los cuatro semianillos con el mismo kernel y compara tiempos
+int run_benchmark(int size, int seed_A, int seed_B) {
+    int **A = allocate_matrix(size);
+    int **B = allocate_matrix(size);
+    int **C = allocate_matrix(size);
+    int all_ok = 1;
+    double baseline = 0.0;
+
+    printf("%-12s %12s %12s %10s\n", "semianillo", "tiempo_wall", "GOPS", "relativo");
+    for (int s = 0; s < NUM_SEMIRINGS; s++) {
+        const semiring_t *sr = &semirings[s];
+        initialize_matrix(A, size, seed_A, sr->modulus);
+        initialize_matrix(B, size, seed_B, sr->modulus);
+
+        double wall_start = get_wall_time();
+        sr->gemm(A, B, C, size);
+        double wall = get_wall_time() - wall_start;
+        if (s == 0) baseline = wall;
+
+        printf("%-12s %12.6f %12.3f %9.2fx\n", sr->name, wall,
+               (2.0 * size * (double)size * (double)size) / (wall * 1e9), wall / baseline);
+        if (!verify_rows(sr, A, B, C, size)) all_ok = 0;
+    }
+    if (all_ok) {
+        printf("✓ Verificación exitosa: los cuatro semianillos coinciden con la referencia escalar\n");
+    }
+    printf("Suma de verificación de la matriz resultado: %lld\n", checksum(C, size));
+
+    free_matrix(A, size);
+    free_matrix(B, size);
+    free_matrix(C, size);
+    return all_ok;
+}
+
+// Grafo dirigido aleatorio: arista i->j con probabilidad `density` y peso en [1, 99]
+void initialize_graph(int **W, int size, int seed, double density) {
+    double threshold = density * ((double)RAND_MAX + 1.0);
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            int edge = (double)rand() < threshold;
+            int weight = 1 + rand() % 99;
+            W[i][j] = (i == j) ? 0 : (edge ? weight : SR_INF);
+        }
+    }
+}
+
+// APSP por cuadrados min-plus sucesivos: D = W (con diagonal 0) cubre caminos
+// de hasta 1 arista y D ⊗ D duplica la longitud cubierta. Se detiene cuando D
+// no cambia; a lo sumo ceil(log2(n - 1)) cuadrados.
+int apsp_min_plus(int **W, int **D, int size) {
+    int **tmp = allocate_matrix(size);
+    int squarings = 0;
+
+    for (int i = 0; i < size; i++) memcpy(D[i], W[i], size * sizeof(int));
+    for (int covered = 1; covered < size - 1; covered *= 2) {
+        gemm_min_plus(D, D, tmp, size);
+        squarings++;
+        int changed = 0;
+        for (int i = 0; i < size; i++) {
+            if (memcmp(tmp[i], D[i], size * sizeof(int)) != 0) {
+                changed = 1;
+                memcpy(D[i], tmp[i], size * sizeof(int));
+            }
+        }
+        if (!changed) break;
+    }
+
+    free_matrix(tmp, size);
+    return squarings;
+}
+
+// Verifica filas de D con Dijkstra (O(n²) con arreglo) desde fuentes muestreadas
+int verify_apsp(int **W, int **D, int size) {
+    int sources = (size < APSP_SOURCES) ? size : APSP_SOURCES;
+    int *dist = (int*)malloc(size * sizeof(int));
+    char *done = (char*)malloc(size);
+    int ok = 1;
+    for (int s = 0; s < sources && ok; s++) {
+        int src = (int)(((long long)s * size) / sources);
+        for (int v = 0; v < size; v++) dist[v] = SR_INF;
+        memset(done, 0, size);
+        dist[src] = 0;
+        for (int it = 0; it < size; it++) {
+            int u = -1;
+            for (int v = 0; v < size; v++) {
+                if (!done[v] && (u < 0 || dist[v] < dist[u])) u = v;
+            }
+            if (dist[u] == SR_INF) break;
+            done[u] = 1;
+            for (int v = 0; v < size; v++) {
+                if (W[u][v] != SR_INF && dist[u] + W[u][v] < dist[v]) dist[v] = dist[u] + W[u][v];
+            }
+        }
+        if (memcmp(dist, D[src], size * sizeof(int)) != 0) {
+            printf("✗ Error: distancias desde %d no coinciden con Dijkstra\n", src);
+            ok = 0;
+        }
+    }
+    free(dist);
+    free(done);
+    return ok;
+}
+
+int run_apsp(int size, double density, int seed) {
+    int **W = allocate_matrix(size);
+    int **D = allocate_matrix(size);
+    double start_time, end_time, wall_start, wall_end;
+
+    initialize_graph(W, size, seed, density);
+
+    start_time = get_user_time();
+    wall_start = get_wall_time();
+    int squarings = apsp_min_plus(W, D, size);
+    end_time = get_user_time();
+    wall_end = get_wall_time();
+
+    long long reachable = 0, total_dist = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (D[i][j] != SR_INF) {
+                reachable++;
+                total_dist += D[i][j];
+            }
+        }
+    }
+    printf("Cuadrados min-plus: %d\n", squarings);
+    printf("Pares alcanzables: %lld de %lld\n", reachable, (long long)size * size);
+    int correct = verify_apsp(W, D, size);
+    if (correct) {
+        printf("✓ Verificación exitosa: las distancias coinciden con Dijkstra\n");
+    }
+    printf("Tiempo de usuario: %.6f segundos\n", end_time - start_time);
+    printf("Tiempo real (wall time): %.6f segundos\n", wall_end - wall_start);
+    printf("Suma de verificación de la matriz resultado: %lld\n", total_dist);
+
+    free_matrix(W, size);
+    free_matrix(D, size);
+    return correct;
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> [modo] [densidad] [semilla_A] [semilla_B]\n", program_name);
+    printf("  tamaño_matriz: Tamaño de las matrices cuadradas (obligatorio)\n");
+    printf("  modo: comparar (los cuatro semianillos con el mismo kernel) o apsp\n");
+    printf("        (caminos mínimos entre todos los pares por cuadrados min-plus)\n");
+    printf("        (opcional, por defecto: comparar)\n");
+    printf("  densidad: Probabilidad de arista en modo apsp (opcional, por defecto: 0.01)\n");
+    printf("  semilla_A: Semilla para generar A / el grafo (opcional, por defecto: tiempo actual)\n");
+    printf("  semilla_B: Semilla para generar matriz B (opcional, por defecto: tiempo actual + 1)\n");
+    printf("\nEjemplo: %s 1024 apsp 0.005 123\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int size;
+    int seed_A, seed_B;
+    double density = 0.01;
+    int apsp = 0;
+
+    if (argc < 2 || argc > 6) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    if (argc >= 3) {
+        if (strcmp(argv[2], "apsp") == 0) apsp = 1;
+        else if (strcmp(argv[2], "comparar") != 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc >= 4) density = atof(argv[3]);
+    if (density < 0.0 || density > 1.0) {
+        printf("Error: La densidad debe estar en [0, 1].\n");
+        return 1;
+    }
+    seed_A = (argc >= 5) ? atoi(argv[4]) : (int)time(NULL);
+    seed_B = (argc == 6) ? atoi(argv[5]) : seed_A + 1;
+
+    int ok = apsp ? run_apsp(size, density, seed_A) : run_benchmark(size, seed_A, seed_B);
+    return ok ? 0 : 1;
+}
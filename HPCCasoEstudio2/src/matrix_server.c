@@ -0,0 +1,541 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include "job_protocol.h"
+
+// Trabajos por debajo de este costo se agrupan en lotes y los corre un solo hilo;
+// los mayores se reparten entre todos los hilos por trozos de filas
+#define SMALL_JOB_FLOPS (2.0 * 128 * 128 * 128)
+#define BATCH_MAX 16
+#define ROW_CHUNK 16
+#define BLOCK_K 64
+#define BLOCK_J 512
+
+// Arena: listas libres por clase de tamaño (potencias de 2 desde 4 KB)
+#define ARENA_MIN_SHIFT 12
+#define ARENA_CLASSES 24
+#define ARENA_MAX_RETAINED (1UL << 30)
+
+typedef struct arena_block {
+    struct arena_block *next;
+} arena_block_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    arena_block_t *free_list[ARENA_CLASSES];
+    size_t retained;
+    uint64_t hits, misses;
+} arena_t;
+
+typedef struct job {
+    job_request_t req;
+    int *A, *B, *C;
+    int small;
+    int next_row;            // Próxima fila sin asignar (trabajos grandes)
+    int rows_done;
+    uint64_t worker_mask;    // Hilos que tomaron al menos un trozo
+    int done;
+    int batch_size;
+    long long checksum;
+    double t_submit, t_start, t_end;
+    pthread_cond_t done_cond;
+    struct job *next;
+} job_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;
+    job_t *head, *tail;
+    int stop;
+    int num_workers;
+    pthread_t *threads;
+    job_stats_t stats;       // Protegido por lock
+} pool_t;
+
+static pool_t pool;
+static arena_t arena;
+static volatile sig_atomic_t server_stop = 0;
+static double server_start;
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// ---------------------------------------------------------------------------
+// Arena de matrices
+// ---------------------------------------------------------------------------
+
+static int arena_class(size_t bytes) {
+    int cls = 0;
+    while (cls < ARENA_CLASSES - 1 && ((size_t)1 << (cls + ARENA_MIN_SHIFT)) < bytes) cls++;
+    return cls;
+}
+
+// Devuelve un buffer de al menos `bytes`, reutilizando uno de la misma clase si hay
+void* arena_get(size_t bytes) {
+    int cls = arena_class(bytes);
+    size_t cls_bytes = (size_t)1 << (cls + ARENA_MIN_SHIFT);
+    if (cls_bytes < bytes) return malloc(bytes);   // Mayor que la última clase
+
+    pthread_mutex_lock(&arena.lock);
+    arena_block_t *b = arena.free_list[cls];
+    if (b != NULL) {
+        arena.free_list[cls] = b->next;
+        arena.retained -= cls_bytes;
+        arena.hits++;
+    } else {
+        arena.misses++;
+    }
+    pthread_mutex_unlock(&arena.lock);
+    return b != NULL ? (void*)b : malloc(cls_bytes);
+}
+
+void arena_put(void *ptr, size_t bytes) {
+    if (ptr == NULL) return;
+    int cls = arena_class(bytes);
+    size_t cls_bytes = (size_t)1 << (cls + ARENA_MIN_SHIFT);
+    if (cls_bytes < bytes) {
+        free(ptr);
+        return;
+    }
+    pthread_mutex_lock(&arena.lock);
+    if (arena.retained + cls_bytes <= ARENA_MAX_RETAINED) {
+        arena_block_t *b = (arena_block_t*)ptr;
+        b->next = arena.free_list[cls];
+        arena.free_list[cls] = b;
+        arena.retained += cls_bytes;
+        ptr = NULL;
+    }
+    pthread_mutex_unlock(&arena.lock);
+    free(ptr);
+}
+
+void arena_destroy(void) {
+    for (int c = 0; c < ARENA_CLASSES; c++) {
+        while (arena.free_list[c] != NULL) {
+            arena_block_t *b = arena.free_list[c];
+            arena.free_list[c] = b->next;
+            free(b);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Cálculo
+// ---------------------------------------------------------------------------
+
+// C[r0:r1) = A[r0:r1) * B con A m x k y B k x n row-major, bloques de k y j
+void multiply_rows(const int *A, const int *B, int *C, int k, int n, int r0, int r1) {
+    memset(&C[(size_t)r0 * n], 0, (size_t)(r1 - r0) * n * sizeof(int));
+    for (int kk = 0; kk < k; kk += BLOCK_K) {
+        int k_end = (kk + BLOCK_K < k) ? kk + BLOCK_K : k;
+        for (int jj = 0; jj < n; jj += BLOCK_J) {
+            int j_end = (jj + BLOCK_J < n) ? jj + BLOCK_J : n;
+            for (int i = r0; i < r1; i++) {
+                int *c_row = &C[(size_t)i * n];
+                for (int p = kk; p < k_end; p++) {
+                    int a = A[(size_t)i * k + p];
+                    const int *b_row = &B[(size_t)p * n];
+                    for (int j = jj; j < j_end; j++) {
+                        c_row[j] += a * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+long long checksum_flat(const int *C, size_t count) {
+    long long sum = 0;
+    for (size_t i = 0; i < count; i++) sum += C[i];
+    return sum;
+}
+
+// Misma secuencia que srand(seed); rand() % 100, pero con estado propio:
+// en glibc rand() es random() con el estado por defecto de 128 bytes, así que
+// random_r con un estado igual reproduce las matrices de los demás programas
+// sin compartir el estado global entre conexiones.
+void generate_matrix(int *M, size_t count, int seed) {
+    struct random_data data;
+    char state[128];
+    int32_t value;
+    memset(&data, 0, sizeof(data));
+    initstate_r((unsigned int)seed, state, sizeof(state), &data);
+    srandom_r((unsigned int)seed, &data);
+    for (size_t i = 0; i < count; i++) {
+        random_r(&data, &value);
+        M[i] = value % 100;
+    }
+}
+
+int load_matrix_file(const char *path, int *M, size_t count) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return 0;
+    size_t got = fread(M, sizeof(int), count, f);
+    fclose(f);
+    return got == count;
+}
+
+// ---------------------------------------------------------------------------
+// Pool de hilos persistente con lotes
+// ---------------------------------------------------------------------------
+
+static void finish_job(job_t *job, long long sum) {
+    job->checksum = sum;
+    job->t_end = get_wall_time();
+    pthread_mutex_lock(&pool.lock);
+    job->done = 1;
+    pthread_cond_signal(&job->done_cond);
+    pthread_mutex_unlock(&pool.lock);
+}
+
+static void unlink_job(job_t *prev, job_t *job) {
+    if (prev == NULL) pool.head = job->next;
+    else prev->next = job->next;
+    if (pool.tail == job) pool.tail = prev;
+    job->next = NULL;
+}
+
+void* worker_main(void *arg) {
+    int id = (int)(intptr_t)arg;
+    job_t *batch[BATCH_MAX];
+
+    for (;;) {
+        pthread_mutex_lock(&pool.lock);
+        while (!pool.stop && pool.head == NULL) {
+            pthread_cond_wait(&pool.work_cond, &pool.lock);
+        }
+        if (pool.head == NULL) {
+            pthread_mutex_unlock(&pool.lock);
+            break;
+        }
+
+        job_t *job = pool.head;
+        if (job->small) {
+            // Lote: todos los trabajos pequeños en cola (hasta BATCH_MAX), en orden
+            int count = 0;
+            job_t *prev = NULL, *cur = pool.head;
+            while (cur != NULL && count < BATCH_MAX) {
+                job_t *next = cur->next;
+                if (cur->small) {
+                    unlink_job(prev, cur);
+                    batch[count++] = cur;
+                } else {
+                    prev = cur;
+                }
+                cur = next;
+            }
+            pool.stats.batches++;
+            pool.stats.batched_jobs += count;
+            pthread_mutex_unlock(&pool.lock);
+
+            for (int b = 0; b < count; b++) {
+                job_t *j = batch[b];
+                j->t_start = get_wall_time();
+                j->batch_size = count;
+                j->worker_mask = 1ULL << (id % 64);
+                multiply_rows(j->A, j->B, j->C, j->req.k, j->req.n, 0, j->req.m);
+                finish_job(j, checksum_flat(j->C, (size_t)j->req.m * j->req.n));
+            }
+        } else {
+            // Trabajo grande: se toma un trozo de filas; el trabajo sale de la cola
+            // cuando ya no quedan filas sin asignar
+            int r0 = job->next_row;
+            int r1 = (r0 + ROW_CHUNK < (int)job->req.m) ? r0 + ROW_CHUNK : (int)job->req.m;
+            if (r0 == 0) {
+                job->t_start = get_wall_time();
+                job->batch_size = 1;
+                pool.stats.split_jobs++;
+            }
+            job->next_row = r1;
+            job->worker_mask |= 1ULL << (id % 64);
+            if (r1 == (int)job->req.m) unlink_job(NULL, job);
+            pthread_mutex_unlock(&pool.lock);
+
+            multiply_rows(job->A, job->B, job->C, job->req.k, job->req.n, r0, r1);
+
+            pthread_mutex_lock(&pool.lock);
+            job->rows_done += r1 - r0;
+            int last = (job->rows_done == (int)job->req.m);
+            pthread_mutex_unlock(&pool.lock);
+            if (last) {
+                finish_job(job, checksum_flat(job->C, (size_t)job->req.m * job->req.n));
+            }
+        }
+    }
+    return NULL;
+}
+
+void pool_start(int num_workers) {
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.work_cond, NULL);
+    pool.num_workers = num_workers;
+    pool.threads = (pthread_t*)malloc(num_workers * sizeof(pthread_t));
+    pool.stats.magic = JOB_MAGIC;
+    pool.stats.workers = num_workers;
+    for (int t = 0; t < num_workers; t++) {
+        pthread_create(&pool.threads[t], NULL, worker_main, (void*)(intptr_t)t);
+    }
+}
+
+void pool_stop(void) {
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.work_cond);
+    pthread_mutex_unlock(&pool.lock);
+    for (int t = 0; t < pool.num_workers; t++) {
+        pthread_join(pool.threads[t], NULL);
+    }
+    free(pool.threads);
+}
+
+// Encola el trabajo y espera a que termine
+void pool_run(job_t *job) {
+    double flops = 2.0 * job->req.m * (double)job->req.k * (double)job->req.n;
+    job->small = flops < SMALL_JOB_FLOPS;
+    job->t_submit = get_wall_time();
+    pthread_cond_init(&job->done_cond, NULL);
+
+    pthread_mutex_lock(&pool.lock);
+    if (pool.tail == NULL) pool.head = job;
+    else pool.tail->next = job;
+    pool.tail = job;
+    // Un trabajo grande puede ocupar a todos los hilos
+    if (job->small) pthread_cond_signal(&pool.work_cond);
+    else pthread_cond_broadcast(&pool.work_cond);
+    while (!job->done) {
+        pthread_cond_wait(&job->done_cond, &pool.lock);
+    }
+    pool.stats.jobs++;
+    pool.stats.flops += flops;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_cond_destroy(&job->done_cond);
+}
+
+void record_latency(double latency, int error) {
+    pthread_mutex_lock(&pool.lock);
+    if (error) pool.stats.errors++;
+    pool.stats.latency_sum += latency;
+    if (latency > pool.stats.latency_max) pool.stats.latency_max = latency;
+    pool.stats.latency_hist[job_latency_bucket(latency)]++;
+    pthread_mutex_unlock(&pool.lock);
+}
+
+// ---------------------------------------------------------------------------
+// Conexiones
+// ---------------------------------------------------------------------------
+
+// Atiende una petición de multiplicación; devuelve 0 si hay que cerrar la conexión
+int handle_multiply(int fd, const job_request_t *req) {
+    double t_recv = get_wall_time();
+    job_response_t resp;
+    memset(&resp, 0, sizeof(resp));
+    resp.magic = JOB_MAGIC;
+    resp.m = req->m;
+    resp.n = req->n;
+
+    if (req->m == 0 || req->k == 0 || req->n == 0 ||
+        req->m > JOB_MAX_DIM || req->k > JOB_MAX_DIM || req->n > JOB_MAX_DIM) {
+        // Con datos inline y forma inválida no se puede resincronizar el flujo
+        resp.status = JOB_ERR_SHAPE;
+        job_write_full(fd, &resp, sizeof(resp));
+        record_latency(get_wall_time() - t_recv, 1);
+        return req->source != JOB_SRC_INLINE;
+    }
+
+    size_t count_a = (size_t)req->m * req->k;
+    size_t count_b = (size_t)req->k * req->n;
+    size_t count_c = (size_t)req->m * req->n;
+    job_t job;
+    memset(&job, 0, sizeof(job));
+    job.req = *req;
+    job.A = (int*)arena_get(count_a * sizeof(int));
+    job.B = (int*)arena_get(count_b * sizeof(int));
+    job.C = (int*)arena_get(count_c * sizeof(int));
+
+    int keep_open = 1;
+    if (job.A == NULL || job.B == NULL || job.C == NULL) {
+        resp.status = JOB_ERR_MEMORY;
+        keep_open = req->source != JOB_SRC_INLINE;
+    } else if (req->source == JOB_SRC_INLINE) {
+        if (!job_read_full(fd, job.A, count_a * sizeof(int)) ||
+            !job_read_full(fd, job.B, count_b * sizeof(int))) {
+            resp.status = JOB_ERR_PROTOCOL;
+            keep_open = 0;
+        }
+    } else if (req->source == JOB_SRC_FILES) {
+        char path_a[JOB_PATH_MAX + 1], path_b[JOB_PATH_MAX + 1];
+        snprintf(path_a, sizeof(path_a), "%.*s", JOB_PATH_MAX, req->path_a);
+        snprintf(path_b, sizeof(path_b), "%.*s", JOB_PATH_MAX, req->path_b);
+        if (!load_matrix_file(path_a, job.A, count_a) || !load_matrix_file(path_b, job.B, count_b)) {
+            resp.status = JOB_ERR_FILE;
+        }
+    } else if (req->source == JOB_SRC_SEEDS) {
+        generate_matrix(job.A, count_a, req->seed_a);
+        generate_matrix(job.B, count_b, req->seed_b);
+    } else {
+        resp.status = JOB_ERR_PROTOCOL;
+        keep_open = 0;
+    }
+
+    if (resp.status == JOB_OK) {
+        pool_run(&job);
+        resp.checksum = job.checksum;
+        resp.batch_size = job.batch_size;
+        resp.workers = __builtin_popcountll(job.worker_mask);
+        resp.queue_wait = job.t_start - job.t_submit;
+        resp.compute_time = job.t_end - job.t_start;
+    }
+    resp.server_time = get_wall_time() - t_recv;
+    record_latency(resp.server_time, resp.status != JOB_OK);
+
+    if (!job_write_full(fd, &resp, sizeof(resp))) keep_open = 0;
+    if (keep_open && resp.status == JOB_OK && req->reply == JOB_REPLY_MATRIX) {
+        if (!job_write_full(fd, job.C, count_c * sizeof(int))) keep_open = 0;
+    }
+
+    arena_put(job.A, count_a * sizeof(int));
+    arena_put(job.B, count_b * sizeof(int));
+    arena_put(job.C, count_c * sizeof(int));
+    return keep_open;
+}
+
+void fill_stats(job_stats_t *out) {
+    pthread_mutex_lock(&pool.lock);
+    *out = pool.stats;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_lock(&arena.lock);
+    out->arena_hits = arena.hits;
+    out->arena_misses = arena.misses;
+    out->arena_bytes = arena.retained;
+    pthread_mutex_unlock(&arena.lock);
+    out->uptime = get_wall_time() - server_start;
+}
+
+void* connection_main(void *arg) {
+    int fd = (int)(intptr_t)arg;
+    job_request_t req;
+
+    while (job_read_full(fd, &req, sizeof(req))) {
+        if (req.magic != JOB_MAGIC) break;
+        if (req.op == JOB_OP_MULTIPLY) {
+            if (!handle_multiply(fd, &req)) break;
+        } else if (req.op == JOB_OP_STATS) {
+            job_stats_t stats;
+            fill_stats(&stats);
+            if (!job_write_full(fd, &stats, sizeof(stats))) break;
+        } else if (req.op == JOB_OP_SHUTDOWN) {
+            job_response_t resp;
+            memset(&resp, 0, sizeof(resp));
+            resp.magic = JOB_MAGIC;
+            job_write_full(fd, &resp, sizeof(resp));
+            server_stop = 1;
+            break;
+        } else {
+            break;
+        }
+    }
+    close(fd);
+    return NULL;
+}
+
+void on_signal(int sig) {
+    (void)sig;
+    server_stop = 1;
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s [hilos] [socket]\n", program_name);
+    printf("  hilos: Hilos de cálculo del pool (opcional, por defecto: CPUs en línea)\n");
+    printf("  socket: Ruta del socket Unix (opcional, por defecto: $MATMUL_SOCKET o %s)\n", JOB_DEFAULT_SOCKET);
+    printf("\nEjemplo: %s 4 /tmp/matmul.sock\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int num_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *path = job_socket_path();
+
+    if (argc > 3) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (argc >= 2) num_workers = atoi(argv[1]);
+    if (argc == 3) path = argv[2];
+    if (num_workers <= 0) {
+        printf("Error: El número de hilos debe ser positivo.\n");
+        return 1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        printf("Error: Ruta de socket demasiado larga.\n");
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(path);
+    if (bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 64) < 0) {
+        perror(path);
+        return 1;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    pthread_mutex_init(&arena.lock, NULL);
+    server_start = get_wall_time();
+    pool_start(num_workers);
+    printf("Servidor escuchando en %s con %d hilos de cálculo\n", path, num_workers);
+    fflush(stdout);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    while (!server_stop) {
+        struct pollfd pfd = {listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        pthread_t tid;
+        if (pthread_create(&tid, &attr, connection_main, (void*)(intptr_t)fd) != 0) {
+            close(fd);
+        }
+    }
+    pthread_attr_destroy(&attr);
+
+    close(listen_fd);
+    unlink(path);
+
+    job_stats_t stats;
+    fill_stats(&stats);
+    pool_stop();
+    printf("Servidor detenido: %llu trabajos, %llu lotes, %llu errores, arena %llu aciertos / %llu fallos\n",
+           (unsigned long long)stats.jobs, (unsigned long long)stats.batches,
+           (unsigned long long)stats.errors, (unsigned long long)stats.arena_hits,
+           (unsigned long long)stats.arena_misses);
+    arena_destroy();
+    return 0;
+}
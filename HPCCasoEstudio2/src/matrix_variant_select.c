@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// Kernels generados por scripts/genera_variantes.py (make variantes)
+#include "matmul_variants_gen.c"
+
+#define MAX_SIZES 32
+#define WINNERS_FILE "variant_winners.csv"
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para inicializar una matriz con valores aleatorios
+void initialize_matrix(int **matrix, int size, int seed) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 100;
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+long long checksum(int **C, int size) {
+    long long sum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            sum += C[i][j];
+        }
+    }
+    return sum;
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaños> [repeticiones] [semilla_A] [semilla_B]\n", program_name);
+    printf("  tamaños: Lista separada por comas, una clase de tamaño por valor (obligatorio)\n");
+    printf("  repeticiones: Corridas por variante, se toma el mínimo (opcional, por defecto: 3)\n");
+    printf("  semilla_A / semilla_B: Semillas de A y B (opcional, por defecto: 12345 / 54321)\n");
+    printf("\nLos ganadores se agregan a %s\n", WINNERS_FILE);
+    printf("Ejemplo: %s 64,256,512,1024 3\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    int sizes[MAX_SIZES];
+    int num_sizes = 0;
+    int repeats = 3;
+    int seed_A = 12345, seed_B = 54321;
+
+    if (argc < 2 || argc > 5) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    char *list = strdup(argv[1]);
+    for (char *tok = strtok(list, ","); tok != NULL && num_sizes < MAX_SIZES; tok = strtok(NULL, ",")) {
+        sizes[num_sizes] = atoi(tok);
+        if (sizes[num_sizes] <= 0) {
+            printf("Error: Los tamaños deben ser números positivos.\n");
+            return 1;
+        }
+        num_sizes++;
+    }
+    free(list);
+    if (argc >= 3) repeats = atoi(argv[2]);
+    if (repeats <= 0) repeats = 1;
+    if (argc >= 4) seed_A = atoi(argv[3]);
+    if (argc == 5) seed_B = atoi(argv[4]);
+
+    FILE *winners = fopen(WINNERS_FILE, "a");
+    if (winners == NULL) {
+        perror(WINNERS_FILE);
+        return 1;
+    }
+    fseek(winners, 0, SEEK_END);
+    if (ftell(winners) == 0) {
+        fprintf(winners, "tamaño_matriz,variante,tiempo_wall,gflops,speedup_vs_ijk\n");
+    }
+
+    printf("%d variantes generadas, %d repeticiones por variante\n", NUM_MATMUL_VARIANTS, repeats);
+
+    int all_ok = 1;
+    for (int s = 0; s < num_sizes; s++) {
+        int n = sizes[s];
+        int **A = allocate_matrix(n);
+        int **B = allocate_matrix(n);
+        int **C = allocate_matrix(n);
+        initialize_matrix(A, n, seed_A);
+        initialize_matrix(B, n, seed_B);
+
+        printf("\n--- Tamaño %d ---\n", n);
+        long long reference = 0;
+        double baseline = 0.0, best_time = 0.0;
+        int best = -1;
+        for (int v = 0; v < NUM_MATMUL_VARIANTS; v++) {
+            double min_wall = -1.0;
+            for (int r = 0; r < repeats; r++) {
+                double wall_start = get_wall_time();
+                matmul_variants[v].fn(A, B, C, n);
+                double wall = get_wall_time() - wall_start;
+                if (min_wall < 0 || wall < min_wall) min_wall = wall;
+            }
+            long long sum = checksum(C, n);
+            if (v == 0) {
+                // La primera variante es ijk_u1_j1: referencia de suma y de tiempo
+                reference = sum;
+                baseline = min_wall;
+            } else if (sum != reference) {
+                printf("✗ %s: suma %lld (esperado %lld)\n", matmul_variants[v].name, sum, reference);
+                all_ok = 0;
+                continue;
+            }
+            printf("%-14s %.6f s  %.3f GFLOPS\n", matmul_variants[v].name, min_wall,
+                   (2.0 * n * (double)n * (double)n) / (min_wall * 1e9));
+            if (best < 0 || min_wall < best_time) {
+                best = v;
+                best_time = min_wall;
+            }
+        }
+        printf("Ganador para %d: %s (%.2fx sobre ijk)\n", n, matmul_variants[best].name, baseline / best_time);
+        fprintf(winners, "%d,%s,%.6f,%.6f,%.4f\n", n, matmul_variants[best].name, best_time,
+                (2.0 * n * (double)n * (double)n) / (best_time * 1e9), baseline / best_time);
+
+        free_matrix(A, n);
+        free_matrix(B, n);
+        free_matrix(C, n);
+    }
+
+    fclose(winners);
+    printf("\nGanadores agregados a %s\n", WINNERS_FILE);
+    return all_ok ? 0 : 1;
+}
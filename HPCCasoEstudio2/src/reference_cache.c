@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "reference_cache.h"
+
+// Función para obtener tiempo real (wall time) en segundos
+double get_wall_time() {
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+// Función para inicializar una matriz con valores aleatorios
+void initialize_matrix(int **matrix, int size, int seed) {
+    srand(seed);
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            matrix[i][j] = rand() % 100; // Valores aleatorios entre 0 y 99
+        }
+    }
+}
+
+// Función para allocar memoria para una matriz cuadrada
+int** allocate_matrix(int size) {
+    int **matrix = (int**)malloc(size * sizeof(int*));
+    for (int i = 0; i < size; i++) {
+        matrix[i] = (int*)malloc(size * sizeof(int));
+    }
+    return matrix;
+}
+
+// Función para liberar la memoria de una matriz
+void free_matrix(int **matrix, int size) {
+    for (int i = 0; i < size; i++) {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// Mismo kernel que matrix_multiplication.c, para que el tiempo guardado sea el baseline
+void matrix_multiply(int **A, int **B, int **C, int size) {
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            C[i][j] = 0;
+            for (int k = 0; k < size; k++) {
+                C[i][j] += A[i][k] * B[k][j];
+            }
+        }
+    }
+}
+
+// Calcula la referencia secuencial (promedio de `repeats` corridas) y la guarda en la caché
+int build_reference(ref_entry_t *ref, int repeats) {
+    int size = ref->n;
+    int **A = allocate_matrix(size);
+    int **B = allocate_matrix(size);
+    int **C = allocate_matrix(size);
+
+    initialize_matrix(A, size, ref->seed_a);
+    initialize_matrix(B, size, ref->seed_b);
+
+    double total_wall = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        double wall_start = get_wall_time();
+        matrix_multiply(A, B, C, size);
+        total_wall += get_wall_time() - wall_start;
+    }
+    ref->seq_wall = total_wall / repeats;
+
+    ref->checksum = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            ref->checksum += C[i][j];
+        }
+        ref->row_hash[i] = ref_row_hash_int(C[i], size);
+    }
+
+    free_matrix(A, size);
+    free_matrix(B, size);
+    free_matrix(C, size);
+
+    return ref_cache_store(ref);
+}
+
+// Función para mostrar ayuda
+void print_usage(char *program_name) {
+    printf("Uso: %s <tamaño_matriz> <semilla_A> <semilla_B> [repeticiones]\n", program_name);
+    printf("  Devuelve la referencia secuencial (suma y tiempo) desde la caché en disco;\n");
+    printf("  si no existe la calcula con `repeticiones` corridas (por defecto 1) y la guarda.\n");
+    printf("  Directorio: $REF_CACHE_DIR (por defecto %s)\n", REF_CACHE_DEFAULT_DIR);
+    printf("\nEjemplo: %s 800 12345 54321 5\n", program_name);
+}
+
+int main(int argc, char *argv[]) {
+    ref_entry_t ref;
+    int repeats = 1;
+
+    if (argc < 4 || argc > 5) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int size = atoi(argv[1]);
+    if (size <= 0) {
+        printf("Error: El tamaño de la matriz debe ser un número positivo.\n");
+        return 1;
+    }
+    if (argc == 5) {
+        repeats = atoi(argv[4]);
+        if (repeats <= 0) repeats = 1;
+    }
+
+    if (!ref_entry_init(&ref, size, atoi(argv[2]), atoi(argv[3]), "int")) {
+        printf("Error: No se pudo alocar memoria para la referencia.\n");
+        return 1;
+    }
+
+    if (ref_cache_load(&ref)) {
+        printf("Caché: acierto\n");
+    } else {
+        printf("Caché: fallo, calculando referencia secuencial...\n");
+        if (!build_reference(&ref, repeats)) {
+            printf("Advertencia: no se pudo escribir la caché en %s\n",
+                   ref_cache_dir() ? ref_cache_dir() : "(desactivada)");
+        }
+    }
+
+    // Mismo formato que los demás ejecutables para reutilizar los scripts
+    printf("Tiempo real (wall time): %.6f segundos\n", ref.seq_wall);
+    printf("Suma de verificación de la matriz resultado: %lld\n", ref.checksum);
+
+    ref_entry_free(&ref);
+    return 0;
+}
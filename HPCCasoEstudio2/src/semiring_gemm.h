@@ -0,0 +1,110 @@
+/*
+ * semiring_gemm.h - GEMM bloqueado/empaquetado genérico sobre un semianillo
+ *
+ * Plantilla en tiempo de compilación: antes de cada #include se definen
+ *   SR_NAME        sufijo de las funciones generadas (p. ej. min_plus)
+ *   SR_ZERO        neutro de la suma del semianillo (C se inicializa con él)
+ *   SR_ADD(x, y)   "suma" del semianillo (+, min, max, |)
+ *   SR_MUL(x, y)   "producto" del semianillo (*, +, &)
+ * y se obtienen, para matrices int** n x n:
+ *   gemm_<SR_NAME>(A, B, C, n)      versión empaquetada + OpenMP + omp simd
+ *   gemm_row_ref_<SR_NAME>(a, B, c, n)  fila c = a ⊗ B escalar, para verificar
+ * Las macros se eliminan al final para poder incluir la plantilla otra vez.
+ *
+ * El bucle interno es c[j] = SR_ADD(c[j], SR_MUL(a, b[j])) con a fijo: para min
+ * y max con enteros el compilador emite vpminsd/vpmaxsd, igual de anchos que
+ * vpmulld/vpaddd, así que los semianillos tropicales vectorizan como el aritmético.
+ */
+#if !defined(SR_NAME) || !defined(SR_ZERO) || !defined(SR_ADD) || !defined(SR_MUL)
+#error "Definir SR_NAME, SR_ZERO, SR_ADD y SR_MUL antes de incluir semiring_gemm.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef SEMIRING_GEMM_BLOCKS
+#define SEMIRING_GEMM_BLOCKS
+// Panel de B de SR_KC x SR_NC contiguo; el micro-kernel avanza SR_MR filas de A
+#define SR_KC 256
+#define SR_NC 512
+#define SR_MR 4
+#define SR_CAT_(a, b) a##_##b
+#define SR_CAT(a, b) SR_CAT_(a, b)
+#endif
+
+#define SR_FN(prefix) SR_CAT(prefix, SR_NAME)
+
+static void SR_FN(gemm_row_ref)(const int *a_row, int **B, int *c_row, int n) {
+    for (int j = 0; j < n; j++) {
+        int acc = SR_ZERO;
+        for (int k = 0; k < n; k++) {
+            acc = SR_ADD(acc, SR_MUL(a_row[k], B[k][j]));
+        }
+        c_row[j] = acc;
+    }
+}
+
+static void SR_FN(gemm)(int **A, int **B, int **C, int n) {
+    int *panel = (int*)malloc((size_t)SR_KC * SR_NC * sizeof(int));
+
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) C[i][j] = SR_ZERO;
+        }
+        for (int jj = 0; jj < n; jj += SR_NC) {
+            int nc = (jj + SR_NC < n) ? SR_NC : n - jj;
+            for (int kk = 0; kk < n; kk += SR_KC) {
+                int kc = (kk + SR_KC < n) ? SR_KC : n - kk;
+
+                #pragma omp for schedule(static)
+                for (int k = 0; k < kc; k++) {
+                    memcpy(&panel[(size_t)k * nc], &B[kk + k][jj], nc * sizeof(int));
+                }
+
+                #pragma omp for schedule(static)
+                for (int i0 = 0; i0 < n; i0 += SR_MR) {
+                    if (i0 + SR_MR <= n) {
+                        int *c0 = &C[i0][jj], *c1 = &C[i0 + 1][jj];
+                        int *c2 = &C[i0 + 2][jj], *c3 = &C[i0 + 3][jj];
+                        for (int k = 0; k < kc; k++) {
+                            int a0 = A[i0][kk + k], a1 = A[i0 + 1][kk + k];
+                            int a2 = A[i0 + 2][kk + k], a3 = A[i0 + 3][kk + k];
+                            const int *p = &panel[(size_t)k * nc];
+                            #pragma omp simd
+                            for (int j = 0; j < nc; j++) {
+                                int b = p[j];
+                                c0[j] = SR_ADD(c0[j], SR_MUL(a0, b));
+                                c1[j] = SR_ADD(c1[j], SR_MUL(a1, b));
+                                c2[j] = SR_ADD(c2[j], SR_MUL(a2, b));
+                                c3[j] = SR_ADD(c3[j], SR_MUL(a3, b));
+                            }
+                        }
+                    } else {
+                        for (int i = i0; i < n; i++) {
+                            int *c_row = &C[i][jj];
+                            for (int k = 0; k < kc; k++) {
+                                int a = A[i][kk + k];
+                                const int *p = &panel[(size_t)k * nc];
+                                #pragma omp simd
+                                for (int j = 0; j < nc; j++) {
+                                    c_row[j] = SR_ADD(c_row[j], SR_MUL(a, p[j]));
+                                }
+                            }
+                        }
+                    }
+                }
+                // Barrera implícita: el panel no se reescribe mientras otro hilo lo usa
+            }
+        }
+    }
+
+    free(panel);
+}
+
+#undef SR_FN
+#undef SR_NAME
+#undef SR_ZERO
+#undef SR_ADD
+#undef SR_MUL
@@ -4,7 +4,7 @@
 # Configuración
 MATRIX_SIZES=(600 1200 2400)  # Divisibles por 2, 4 y 6
 PROCESS_COUNTS=(2 4 6)
-IMPLEMENTATIONS=("sequential" "rowwise" "broadcast" "nonblocking")
+IMPLEMENTATIONS=("sequential" "rowwise" "broadcast" "nonblocking" "summa" "cannon" "25d")
 RESULTS_FILE="./results/benchmarks.csv"
 HOSTFILE="./hostfile"
 NUM_RUNS=10  # Número de repeticiones por configuración
@@ -50,6 +50,19 @@ run_benchmark() {
         return
     fi
     
+    # Cannon necesita una malla cuadrada (procs = q*q); 2.5D con c = 2, procs = q*q*2
+    local layers=0
+    [ "$impl" = "cannon" ] && layers=1
+    [ "$impl" = "25d" ] && layers=2
+    if [ $layers -gt 0 ]; then
+        local q=$(awk -v p=$procs -v c=$layers 'BEGIN { printf "%d", sqrt(p / c) + 0.5 }')
+        if [ $((q * q * layers)) -ne $procs ]; then
+            echo "SKIP (needs q*q*${layers} processes)"
+            echo "${impl},${size},${procs},${run},0.0,skipped" >> $RESULTS_FILE
+            return
+        fi
+    fi
+    
     # Ejecutar con timeout de 5 minutos
     output=$(timeout 300 mpirun --hostfile $HOSTFILE -np $procs $binary $size 2>&1)
     exit_code=$?
@@ -2,12 +2,15 @@
  * Matrix Multiplication - MPI Broadcast Optimized
  * Optimiza la comunicación: solo Broadcast de B (no scatter/gather)
  * Cada proceso calcula un bloque de filas y retorna solo su porción
+ * Filas repartidas con MPI_Scatterv/MPI_Gatherv según row_partition.h:
+ * iguales, por calibración de velocidad o por archivo de pesos (cualquier n)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <mpi.h>
 #include <time.h>
+#include "row_partition.h"
 
 void initialize_matrix(double *matrix, int rows, int cols, int seed) {
     srand(seed);
@@ -33,7 +36,8 @@ int main(int argc, char *argv[]) {
     int matrix_size;
     double *A = NULL, *B = NULL, *C = NULL;
     double *A_local = NULL, *C_local = NULL;
-    int local_rows, start_row;
+    int local_rows;
+    rp_plan_t plan;
     double start_time, end_time, total_time;
     double comm_start, comm_time = 0.0, compute_time = 0.0;
     
@@ -41,9 +45,9 @@ int main(int argc, char *argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
     
-    if (argc != 2) {
+    if (argc < 2 || argc > 3) {
         if (rank == 0) {
-            printf("Uso: mpirun -np <procs> %s <matrix_size>\n", argv[0]);
+            printf("Uso: mpirun -np <procs> %s <matrix_size> [equal|calibrate|weights_file]\n", argv[0]);
         }
         MPI_Finalize();
         return 1;
@@ -51,16 +55,23 @@ int main(int argc, char *argv[]) {
     
     matrix_size = atoi(argv[1]);
     
-    if (matrix_size % num_procs != 0) {
+    if (matrix_size <= 0) {
         if (rank == 0) {
-            printf("Error: Matrix size must be divisible by number of processes\n");
+            printf("Error: Matrix size must be positive\n");
         }
         MPI_Finalize();
         return 1;
     }
     
-    local_rows = matrix_size / num_procs;
-    start_row = rank * local_rows;
+    // Rows per rank (calibration runs here, outside the timed region)
+    if (!rp_plan(&plan, matrix_size, (argc == 3) ? argv[2] : "equal", MPI_COMM_WORLD)) {
+        if (rank == 0) {
+            printf("Error: Could not read weights file %s\n", argv[2]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    local_rows = plan.rows[rank];
     
     start_time = MPI_Wtime();
     
@@ -72,7 +83,7 @@ int main(int argc, char *argv[]) {
         printf("=== MPI Broadcast Optimized ===\n");
         printf("Matrix size: %d x %d\n", matrix_size, matrix_size);
         printf("Number of processes: %d\n", num_procs);
-        printf("Rows per process: %d\n", local_rows);
+        rp_print(&plan);
         printf("Optimization: Single Bcast for B, direct row computation\n\n");
         
         A = (double*)malloc(matrix_size * matrix_size * sizeof(double));
@@ -83,19 +94,19 @@ int main(int argc, char *argv[]) {
     }
     
     // Allocate local working buffers
-    A_local = (double*)malloc(local_rows * matrix_size * sizeof(double));
-    C_local = (double*)malloc(local_rows * matrix_size * sizeof(double));
+    A_local = (double*)malloc((local_rows * matrix_size + 1) * sizeof(double));
+    C_local = (double*)malloc((local_rows * matrix_size + 1) * sizeof(double));
     
     // Broadcast matrix B to all processes (single communication)
     comm_start = MPI_Wtime();
     MPI_Bcast(B, matrix_size * matrix_size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
     comm_time += MPI_Wtime() - comm_start;
     
-    // Scatter rows of A
+    // Scatter rows of A (uneven counts)
     comm_start = MPI_Wtime();
-    MPI_Scatter(A, local_rows * matrix_size, MPI_DOUBLE,
-                A_local, local_rows * matrix_size, MPI_DOUBLE,
-                0, MPI_COMM_WORLD);
+    MPI_Scatterv(A, plan.counts, plan.displs, MPI_DOUBLE,
+                 A_local, local_rows * matrix_size, MPI_DOUBLE,
+                 0, MPI_COMM_WORLD);
     comm_time += MPI_Wtime() - comm_start;
     
     // Computation phase
@@ -105,9 +116,9 @@ int main(int argc, char *argv[]) {
     
     // Gather results
     comm_start = MPI_Wtime();
-    MPI_Gather(C_local, local_rows * matrix_size, MPI_DOUBLE,
-               C, local_rows * matrix_size, MPI_DOUBLE,
-               0, MPI_COMM_WORLD);
+    MPI_Gatherv(C_local, local_rows * matrix_size, MPI_DOUBLE,
+                C, plan.counts, plan.displs, MPI_DOUBLE,
+                0, MPI_COMM_WORLD);
     comm_time += MPI_Wtime() - comm_start;
     
     end_time = MPI_Wtime();
@@ -153,6 +164,7 @@ int main(int argc, char *argv[]) {
     free(B);
     free(A_local);
     free(C_local);
+    rp_free(&plan);
     
     MPI_Finalize();
     return 0;
@@ -0,0 +1,277 @@
+/*
+ * Matrix Multiplication - MPI Cannon (toro 2D periódico)
+ * Los P = q x q procesos forman un toro (MPI_Cart_create con periods = 1).
+ * Cada rango guarda un bloque de A, B y C; tras un sesgo inicial (fila i de A
+ * desplazada i posiciones a la izquierda, columna j de B desplazada j hacia
+ * arriba) cada paso multiplica los bloques locales y desplaza A una posición
+ * a la izquierda y B una hacia arriba. Solo hay tráfico entre vecinos y la
+ * memoria por rango es constante en P: O(n^2/P).
+ * Modo "overlap" (por defecto): doble buffer con MPI_Isend/MPI_Irecv, el
+ * desplazamiento del paso k+1 viaja mientras se calcula el paso k.
+ * Modo "replace": MPI_Sendrecv_replace bloqueante, como referencia.
+ * Cualquier n: se rellena con ceros hasta un múltiplo de q.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include <time.h>
+
+#define KERNEL_BLOCK_I 32
+#define KERNEL_BLOCK_J 256
+
+// Fills the bs x bs block starting at (r0, c0) with the values initialize_matrix
+// produces for the full n x n matrix; cells beyond n are the zero padding
+void initialize_block(double *local, int n, int bs, int r0, int c0, int seed) {
+    memset(local, 0, (size_t)bs * bs * sizeof(double));
+    srand(seed);
+    for (int i = 0; i < n && i < r0 + bs; i++) {
+        for (int j = 0; j < n; j++) {
+            int value = rand() % 100;
+            if (i >= r0 && j >= c0 && j < c0 + bs) {
+                local[(size_t)(i - r0) * bs + (j - c0)] = (double)value;
+            }
+        }
+    }
+}
+
+// C (bs x bs) += A (bs x bs) * B (bs x bs), blocked over rows and columns
+void block_multiply(const double *A, const double *B, double *C, int bs) {
+    for (int ii = 0; ii < bs; ii += KERNEL_BLOCK_I) {
+        int i_end = (ii + KERNEL_BLOCK_I < bs) ? ii + KERNEL_BLOCK_I : bs;
+        for (int jj = 0; jj < bs; jj += KERNEL_BLOCK_J) {
+            int j_end = (jj + KERNEL_BLOCK_J < bs) ? jj + KERNEL_BLOCK_J : bs;
+            for (int i = ii; i < i_end; i++) {
+                double *c_row = &C[(size_t)i * bs];
+                for (int k = 0; k < bs; k++) {
+                    double a = A[(size_t)i * bs + k];
+                    const double *b_row = &B[(size_t)k * bs];
+                    for (int j = jj; j < j_end; j++) {
+                        c_row[j] += a * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int rank, num_procs;
+    int matrix_size, overlap = 1;
+    double start_time, total_time;
+    double comm_start, comm_time = 0.0, compute_time = 0.0, skew_time;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    if (argc < 2 || argc > 3) {
+        if (rank == 0) {
+            printf("Uso: mpirun -np <q*q procs> %s <matrix_size> [overlap|replace]\n", argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    matrix_size = atoi(argv[1]);
+    if (argc == 3) {
+        if (strcmp(argv[2], "replace") == 0) {
+            overlap = 0;
+        } else if (strcmp(argv[2], "overlap") != 0) {
+            if (rank == 0) printf("Error: Unknown shift mode '%s' (overlap|replace)\n", argv[2]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    int q = (int)(sqrt((double)num_procs) + 0.5);
+    if (q * q != num_procs || matrix_size <= 0) {
+        if (rank == 0) {
+            printf("Error: Cannon needs a perfect square number of processes (1, 4, 9, ...) "
+                   "and a positive matrix size\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // Periodic q x q torus
+    int dims[2] = {q, q}, periods[2] = {1, 1}, coords[2];
+    MPI_Comm torus;
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &torus);
+    MPI_Comm_rank(torus, &rank);
+    MPI_Cart_coords(torus, rank, 2, coords);
+    int my_row = coords[0], my_col = coords[1];
+
+    // Neighbours for one-step shifts: A moves left along the row, B moves up the column
+    int left, right, up, down;
+    MPI_Cart_shift(torus, 1, -1, &right, &left);
+    MPI_Cart_shift(torus, 0, -1, &down, &up);
+
+    int bs = (matrix_size + q - 1) / q;
+    int padded = bs * q;
+    size_t block_elems = (size_t)bs * bs;
+
+    if (rank == 0) {
+        printf("=== MPI Cannon (periodic 2D torus) ===\n");
+        printf("Matrix size: %d x %d\n", matrix_size, matrix_size);
+        printf("Number of processes: %d\n", num_procs);
+        printf("Process grid: %d x %d (periodic)\n", q, q);
+        printf("Block per process: %d x %d", bs, bs);
+        if (padded != matrix_size) printf(" (padded to %d)", padded);
+        printf("\nShift mode: %s\n\n", overlap ? "overlap (Isend/Irecv, double buffer)"
+                                               : "replace (Sendrecv_replace)");
+    }
+
+    // Current and next blocks of A and B (the second pair is only used with overlap)
+    double *A_cur = (double*)malloc(block_elems * sizeof(double));
+    double *B_cur = (double*)malloc(block_elems * sizeof(double));
+    double *A_next = (double*)malloc(block_elems * sizeof(double));
+    double *B_next = (double*)malloc(block_elems * sizeof(double));
+    double *C_local = (double*)calloc(block_elems, sizeof(double));
+    if (!A_cur || !B_cur || !A_next || !B_next || !C_local) {
+        fprintf(stderr, "Rank %d: out of memory\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    int r0 = my_row * bs, c0 = my_col * bs;
+    initialize_block(A_cur, matrix_size, bs, r0, c0, 12345);
+    initialize_block(B_cur, matrix_size, bs, r0, c0, 54321);
+
+    // Column sums of A and row sums of B for the checksum, before blocks move
+    double *colsum_A = (double*)calloc(padded, sizeof(double));
+    double *rowsum_B = (double*)calloc(padded, sizeof(double));
+    for (int i = 0; i < bs; i++) {
+        for (int j = 0; j < bs; j++) {
+            colsum_A[c0 + j] += A_cur[(size_t)i * bs + j];
+            rowsum_B[r0 + i] += B_cur[(size_t)i * bs + j];
+        }
+    }
+
+    MPI_Barrier(torus);
+    start_time = MPI_Wtime();
+
+    // Initial skew: A(i,j) <- A(i,j+i), B(i,j) <- B(i+j,j)
+    comm_start = MPI_Wtime();
+    int src, dst;
+    MPI_Cart_shift(torus, 1, -my_row, &src, &dst);
+    MPI_Sendrecv_replace(A_cur, (int)block_elems, MPI_DOUBLE, dst, 0, src, 0, torus, MPI_STATUS_IGNORE);
+    MPI_Cart_shift(torus, 0, -my_col, &src, &dst);
+    MPI_Sendrecv_replace(B_cur, (int)block_elems, MPI_DOUBLE, dst, 1, src, 1, torus, MPI_STATUS_IGNORE);
+    skew_time = MPI_Wtime() - comm_start;
+    comm_time += skew_time;
+
+    for (int step = 0; step < q; step++) {
+        int last = (step == q - 1);
+
+        if (overlap) {
+            // Post the shift for the next step, compute, then wait for it
+            MPI_Request reqs[4];
+            int nreqs = 0;
+            if (!last) {
+                MPI_Irecv(A_next, (int)block_elems, MPI_DOUBLE, right, 0, torus, &reqs[nreqs++]);
+                MPI_Irecv(B_next, (int)block_elems, MPI_DOUBLE, down, 1, torus, &reqs[nreqs++]);
+                MPI_Isend(A_cur, (int)block_elems, MPI_DOUBLE, left, 0, torus, &reqs[nreqs++]);
+                MPI_Isend(B_cur, (int)block_elems, MPI_DOUBLE, up, 1, torus, &reqs[nreqs++]);
+            }
+
+            double comp_start = MPI_Wtime();
+            block_multiply(A_cur, B_cur, C_local, bs);
+            compute_time += MPI_Wtime() - comp_start;
+
+            if (!last) {
+                comm_start = MPI_Wtime();
+                MPI_Waitall(nreqs, reqs, MPI_STATUSES_IGNORE);
+                comm_time += MPI_Wtime() - comm_start;
+
+                double *tmp = A_cur; A_cur = A_next; A_next = tmp;
+                tmp = B_cur; B_cur = B_next; B_next = tmp;
+            }
+        } else {
+            double comp_start = MPI_Wtime();
+            block_multiply(A_cur, B_cur, C_local, bs);
+            compute_time += MPI_Wtime() - comp_start;
+
+            if (!last) {
+                comm_start = MPI_Wtime();
+                MPI_Sendrecv_replace(A_cur, (int)block_elems, MPI_DOUBLE, left, 0, right, 0,
+                                     torus, MPI_STATUS_IGNORE);
+                MPI_Sendrecv_replace(B_cur, (int)block_elems, MPI_DOUBLE, up, 1, down, 1,
+                                     torus, MPI_STATUS_IGNORE);
+                comm_time += MPI_Wtime() - comm_start;
+            }
+        }
+    }
+
+    total_time = MPI_Wtime() - start_time;
+
+    // Checksum: sum(C) must equal sum_k colsum_A[k] * rowsum_B[k]
+    double local_sum = 0.0, c_sum = 0.0, expected = 0.0;
+    for (size_t e = 0; e < block_elems; e++) local_sum += C_local[e];
+    MPI_Reduce(&local_sum, &c_sum, 1, MPI_DOUBLE, MPI_SUM, 0, torus);
+    MPI_Allreduce(MPI_IN_PLACE, colsum_A, padded, MPI_DOUBLE, MPI_SUM, torus);
+    MPI_Allreduce(MPI_IN_PLACE, rowsum_B, padded, MPI_DOUBLE, MPI_SUM, torus);
+    for (int k = 0; k < padded; k++) expected += colsum_A[k] * rowsum_B[k];
+
+    // C[n-1][n-1] lives in block ((n-1)/bs, (n-1)/bs)
+    double corner = 0.0;
+    int corner_coords[2] = {(matrix_size - 1) / bs, (matrix_size - 1) / bs}, corner_rank;
+    MPI_Cart_rank(torus, corner_coords, &corner_rank);
+    if (rank == corner_rank) {
+        int li = (matrix_size - 1) - corner_coords[0] * bs;
+        corner = C_local[(size_t)li * bs + li];
+    }
+    MPI_Bcast(&corner, 1, MPI_DOUBLE, corner_rank, torus);
+
+    // Collect timing statistics from all processes
+    double max_compute, min_compute, avg_compute;
+    double max_comm, min_comm, avg_comm, max_skew;
+    MPI_Reduce(&compute_time, &max_compute, 1, MPI_DOUBLE, MPI_MAX, 0, torus);
+    MPI_Reduce(&compute_time, &min_compute, 1, MPI_DOUBLE, MPI_MIN, 0, torus);
+    MPI_Reduce(&compute_time, &avg_compute, 1, MPI_DOUBLE, MPI_SUM, 0, torus);
+    MPI_Reduce(&comm_time, &max_comm, 1, MPI_DOUBLE, MPI_MAX, 0, torus);
+    MPI_Reduce(&comm_time, &min_comm, 1, MPI_DOUBLE, MPI_MIN, 0, torus);
+    MPI_Reduce(&comm_time, &avg_comm, 1, MPI_DOUBLE, MPI_SUM, 0, torus);
+    MPI_Reduce(&skew_time, &max_skew, 1, MPI_DOUBLE, MPI_MAX, 0, torus);
+
+    if (rank == 0) {
+        avg_compute /= num_procs;
+        avg_comm /= num_procs;
+
+        printf("Results:\n");
+        printf("Total time: %.6f seconds\n", total_time);
+        printf("Cannon steps: %d\n", q);
+        printf("\nComputation time:\n");
+        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n",
+               max_compute, min_compute, avg_compute);
+        printf("Communication time (%s):\n", overlap ? "exposed wait" : "blocking shifts");
+        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n",
+               max_comm, min_comm, avg_comm);
+        printf("  Initial skew: %.6f s (max)\n", max_skew);
+        printf("\nLoad balance: %.2f%% (min/max compute)\n",
+               (min_compute / max_compute) * 100.0);
+        printf("Comm overhead: %.2f%% of total time\n",
+               (max_comm / total_time) * 100.0);
+        printf("Per-rank memory: %.2f MB (5 blocks, full matrix: %.2f MB)\n",
+               5.0 * block_elems * sizeof(double) / (1024.0 * 1024.0),
+               (double)matrix_size * matrix_size * sizeof(double) / (1024.0 * 1024.0));
+
+        printf("\nSample results:\n");
+        printf("C[0][0] = %.2f\n", C_local[0]);
+        printf("C[%d][%d] = %.2f\n", matrix_size-1, matrix_size-1, corner);
+        printf("Checksum: %.0f (expected %.0f) %s\n", c_sum, expected,
+               c_sum == expected ? "✓" : "✗");
+    }
+
+    free(colsum_A);
+    free(rowsum_B);
+    free(A_cur);
+    free(B_cur);
+    free(A_next);
+    free(B_next);
+    free(C_local);
+    MPI_Comm_free(&torus);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -1,13 +1,25 @@
 /*
  * Matrix Multiplication - MPI Non-blocking Communication
- * Usa MPI_Isend/MPI_Irecv para overlap computation/communication
- * Pipeline: mientras procesa datos actuales, recibe próximos
+ * B se reparte en paneles de columnas con MPI_Ibcast en pipeline: mientras se
+ * calcula A_local x panel_j, los paneles j+1 .. j+depth siguen en vuelo.
+ * Ancho de panel y profundidad configurables; los workers guardan solo
+ * depth+1 paneles de B, no la matriz completa.
+ * La eficiencia de overlap sale del tiempo de espera medido frente a un
+ * reparto de referencia de los mismos paneles sin cómputo.
+ * Filas de A/C repartidas con MPI_Scatterv/MPI_Gatherv según row_partition.h
+ * (iguales, por calibración de velocidad o por archivo de pesos; cualquier n).
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mpi.h>
 #include <time.h>
+#include "row_partition.h"
+
+#define DEFAULT_PANEL 64
+#define DEFAULT_DEPTH 2
+#define PROGRESS_ROWS 16         // Rows computed between MPI progress polls
 
 void initialize_matrix(double *matrix, int rows, int cols, int seed) {
     srand(seed);
@@ -16,196 +28,230 @@ void initialize_matrix(double *matrix, int rows, int cols, int seed) {
     }
 }
 
-void matrix_multiply_rows(double *A_local, double *B, double *C_local, 
-                          int local_rows, int size) {
+// Copies columns [col0, col0+width) of B (size x size) into a contiguous panel
+void pack_panel(const double *B, double *panel, int size, int col0, int width) {
+    for (int k = 0; k < size; k++) {
+        memcpy(&panel[k * width], &B[k * size + col0], width * sizeof(double));
+    }
+}
+
+// Gives MPI a chance to advance the panels still in flight
+void poke_progress(MPI_Request *reqs, int count) {
+    int flag;
+    for (int r = 0; r < count; r++) {
+        if (reqs[r] != MPI_REQUEST_NULL) MPI_Test(&reqs[r], &flag, MPI_STATUS_IGNORE);
+    }
+}
+
+// C_local[:, col0:col0+width] = A_local x panel, polling MPI every few rows
+void multiply_panel(const double *A_local, const double *panel, double *C_local,
+                    int local_rows, int size, int col0, int width,
+                    MPI_Request *inflight, int num_inflight) {
     for (int i = 0; i < local_rows; i++) {
-        for (int j = 0; j < size; j++) {
-            C_local[i * size + j] = 0.0;
-            for (int k = 0; k < size; k++) {
-                C_local[i * size + j] += A_local[i * size + k] * B[k * size + j];
+        double *c_row = &C_local[i * size + col0];
+        for (int j = 0; j < width; j++) c_row[j] = 0.0;
+        for (int k = 0; k < size; k++) {
+            double a = A_local[i * size + k];
+            const double *p_row = &panel[k * width];
+            for (int j = 0; j < width; j++) {
+                c_row[j] += a * p_row[j];
             }
         }
+        if ((i + 1) % PROGRESS_ROWS == 0) poke_progress(inflight, num_inflight);
     }
 }
 
 int main(int argc, char *argv[]) {
     int rank, num_procs;
-    int matrix_size;
+    int matrix_size, panel_width, depth;
     double *A = NULL, *B = NULL, *C = NULL;
-    double *A_local = NULL, *C_local = NULL;
+    double *A_local = NULL, *C_local = NULL, *panels = NULL;
     int local_rows;
+    rp_plan_t plan;
     double start_time, end_time, total_time;
-    double comm_time = 0.0, compute_time = 0.0;
-    MPI_Request *send_requests = NULL, *recv_requests = NULL;
-    MPI_Status *send_status = NULL, *recv_status = NULL;
-    
+    double comm_time = 0.0, compute_time = 0.0, wait_time = 0.0, reference_time;
+
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
-    
-    if (argc != 2) {
+
+    if (argc < 2 || argc > 5) {
         if (rank == 0) {
-            printf("Uso: mpirun -np <procs> %s <matrix_size>\n", argv[0]);
+            printf("Uso: mpirun -np <procs> %s <matrix_size> [panel_width] [depth] "
+                   "[equal|calibrate|weights_file]\n", argv[0]);
         }
         MPI_Finalize();
         return 1;
     }
-    
+
     matrix_size = atoi(argv[1]);
-    
-    if (matrix_size % num_procs != 0) {
+    panel_width = (argc >= 3) ? atoi(argv[2]) : DEFAULT_PANEL;
+    depth = (argc >= 4) ? atoi(argv[3]) : DEFAULT_DEPTH;
+
+    if (matrix_size <= 0 || panel_width <= 0 || depth <= 0) {
         if (rank == 0) {
-            printf("Error: Matrix size must be divisible by number of processes\n");
+            printf("Error: Matrix size, panel width and depth must be positive\n");
         }
         MPI_Finalize();
         return 1;
     }
-    
-    local_rows = matrix_size / num_procs;
-    
-    start_time = MPI_Wtime();
-    
-    // Allocate B on all processes
-    B = (double*)malloc(matrix_size * matrix_size * sizeof(double));
-    A_local = (double*)malloc(local_rows * matrix_size * sizeof(double));
-    C_local = (double*)malloc(local_rows * matrix_size * sizeof(double));
-    
+    if (panel_width > matrix_size) panel_width = matrix_size;
+
+    // Rows per rank (calibration runs here, outside the timed region)
+    if (!rp_plan(&plan, matrix_size, (argc == 5) ? argv[4] : "equal", MPI_COMM_WORLD)) {
+        if (rank == 0) {
+            printf("Error: Could not read weights file %s\n", argv[4]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    local_rows = plan.rows[rank];
+    int num_panels = (matrix_size + panel_width - 1) / panel_width;
+    if (depth > num_panels) depth = num_panels;
+    int slots = depth + 1;       // depth panels in flight plus the one being computed
+    size_t panel_elems = (size_t)matrix_size * panel_width;
+
+    A_local = (double*)malloc((local_rows * matrix_size + 1) * sizeof(double));
+    C_local = (double*)malloc((local_rows * matrix_size + 1) * sizeof(double));
+    panels = (double*)malloc(slots * panel_elems * sizeof(double));
+
     if (rank == 0) {
         printf("=== MPI Non-blocking Communication ===\n");
         printf("Matrix size: %d x %d\n", matrix_size, matrix_size);
         printf("Number of processes: %d\n", num_procs);
-        printf("Rows per process: %d\n", local_rows);
-        printf("Optimization: MPI_Isend/MPI_Irecv for overlap\n\n");
-        
+        rp_print(&plan);
+        printf("Optimization: MPI_Ibcast pipeline of B column panels\n");
+        printf("Panel width: %d  Panels: %d  Depth: %d\n\n", panel_width, num_panels, depth);
+
         A = (double*)malloc(matrix_size * matrix_size * sizeof(double));
+        B = (double*)malloc(matrix_size * matrix_size * sizeof(double));
         C = (double*)malloc(matrix_size * matrix_size * sizeof(double));
-        
+
         initialize_matrix(A, matrix_size, matrix_size, 12345);
         initialize_matrix(B, matrix_size, matrix_size, 54321);
-        
-        // Non-blocking send of matrix B to all processes
-        double comm_start = MPI_Wtime();
-        send_requests = (MPI_Request*)malloc((num_procs - 1) * sizeof(MPI_Request));
-        send_status = (MPI_Status*)malloc((num_procs - 1) * sizeof(MPI_Status));
-        
-        for (int i = 1; i < num_procs; i++) {
-            MPI_Isend(B, matrix_size * matrix_size, MPI_DOUBLE, 
-                     i, 0, MPI_COMM_WORLD, &send_requests[i-1]);
-        }
-        
-        // Non-blocking send of A rows to workers
-        for (int i = 1; i < num_procs; i++) {
-            MPI_Isend(&A[i * local_rows * matrix_size], local_rows * matrix_size, 
-                     MPI_DOUBLE, i, 1, MPI_COMM_WORLD, &send_requests[i-1]);
-        }
-        
-        // Copy local data for rank 0
-        for (int i = 0; i < local_rows * matrix_size; i++) {
-            A_local[i] = A[i];
-        }
-        comm_time += MPI_Wtime() - comm_start;
-        
-    } else {
-        // Workers receive B and their A rows using non-blocking receives
-        double comm_start = MPI_Wtime();
-        MPI_Request req_B, req_A;
-        MPI_Status stat_B, stat_A;
-        
-        MPI_Irecv(B, matrix_size * matrix_size, MPI_DOUBLE, 
-                 0, 0, MPI_COMM_WORLD, &req_B);
-        MPI_Irecv(A_local, local_rows * matrix_size, MPI_DOUBLE, 
-                 0, 1, MPI_COMM_WORLD, &req_A);
-        
-        // Wait for data to arrive
-        MPI_Wait(&req_B, &stat_B);
-        MPI_Wait(&req_A, &stat_A);
-        comm_time += MPI_Wtime() - comm_start;
     }
-    
-    // All processes compute their portion
-    double comp_start = MPI_Wtime();
-    matrix_multiply_rows(A_local, B, C_local, local_rows, matrix_size);
-    compute_time = MPI_Wtime() - comp_start;
-    
-    // Non-blocking gather results
+
+    // Reference: the same panels broadcast with blocking MPI_Bcast and no compute
+    MPI_Barrier(MPI_COMM_WORLD);
+    double ref_start = MPI_Wtime();
+    for (int p = 0; p < num_panels; p++) {
+        int col0 = p * panel_width;
+        int width = (col0 + panel_width <= matrix_size) ? panel_width : matrix_size - col0;
+        if (rank == 0) pack_panel(B, panels, matrix_size, col0, width);
+        MPI_Bcast(panels, matrix_size * width, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+    reference_time = MPI_Wtime() - ref_start;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    start_time = MPI_Wtime();
+
+    // Rows of A first, so that the wait for the first panel is not hidden in it
     double comm_start = MPI_Wtime();
-    if (rank == 0) {
-        // Copy rank 0's results
-        for (int i = 0; i < local_rows * matrix_size; i++) {
-            C[i] = C_local[i];
-        }
-        
-        // Receive from workers
-        recv_requests = (MPI_Request*)malloc((num_procs - 1) * sizeof(MPI_Request));
-        recv_status = (MPI_Status*)malloc((num_procs - 1) * sizeof(MPI_Status));
-        
-        for (int i = 1; i < num_procs; i++) {
-            MPI_Irecv(&C[i * local_rows * matrix_size], local_rows * matrix_size, 
-                     MPI_DOUBLE, i, 2, MPI_COMM_WORLD, &recv_requests[i-1]);
+    MPI_Scatterv(A, plan.counts, plan.displs, MPI_DOUBLE,
+                 A_local, local_rows * matrix_size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    // Pipeline: panel p lives in slot p % slots; panels p+1 .. p+depth are in flight
+    MPI_Request *panel_reqs = (MPI_Request*)malloc(slots * sizeof(MPI_Request));
+    for (int s = 0; s < slots; s++) panel_reqs[s] = MPI_REQUEST_NULL;
+    int posted = 0;
+    while (posted < depth) {
+        int col0 = posted * panel_width;
+        int width = (col0 + panel_width <= matrix_size) ? panel_width : matrix_size - col0;
+        double *slot = &panels[(posted % slots) * panel_elems];
+        if (rank == 0) pack_panel(B, slot, matrix_size, col0, width);
+        MPI_Ibcast(slot, matrix_size * width, MPI_DOUBLE, 0, MPI_COMM_WORLD, &panel_reqs[posted % slots]);
+        posted++;
+    }
+    comm_time += MPI_Wtime() - comm_start;
+
+    for (int p = 0; p < num_panels; p++) {
+        int col0 = p * panel_width;
+        int width = (col0 + panel_width <= matrix_size) ? panel_width : matrix_size - col0;
+
+        double wait_start = MPI_Wtime();
+        MPI_Wait(&panel_reqs[p % slots], MPI_STATUS_IGNORE);
+        wait_time += MPI_Wtime() - wait_start;
+
+        // Keep the pipeline full before computing on panel p
+        if (posted < num_panels) {
+            double post_start = MPI_Wtime();
+            int next_col0 = posted * panel_width;
+            int next_width = (next_col0 + panel_width <= matrix_size) ? panel_width : matrix_size - next_col0;
+            double *slot = &panels[(posted % slots) * panel_elems];
+            if (rank == 0) pack_panel(B, slot, matrix_size, next_col0, next_width);
+            MPI_Ibcast(slot, matrix_size * next_width, MPI_DOUBLE, 0, MPI_COMM_WORLD,
+                       &panel_reqs[posted % slots]);
+            posted++;
+            comm_time += MPI_Wtime() - post_start;
         }
-        
-        // Wait for all results
-        MPI_Waitall(num_procs - 1, recv_requests, recv_status);
-        
-        // Wait for initial sends to complete
-        MPI_Waitall(num_procs - 1, send_requests, send_status);
-        
-    } else {
-        // Workers send their results back
-        MPI_Request req_send;
-        MPI_Isend(C_local, local_rows * matrix_size, MPI_DOUBLE, 
-                 0, 2, MPI_COMM_WORLD, &req_send);
-        MPI_Wait(&req_send, MPI_STATUS_IGNORE);
+
+        double comp_start = MPI_Wtime();
+        multiply_panel(A_local, &panels[(p % slots) * panel_elems], C_local,
+                       local_rows, matrix_size, col0, width, panel_reqs, slots);
+        compute_time += MPI_Wtime() - comp_start;
     }
+    comm_time += wait_time;
+    free(panel_reqs);
+
+    // Gather results
+    comm_start = MPI_Wtime();
+    MPI_Gatherv(C_local, local_rows * matrix_size, MPI_DOUBLE,
+                C, plan.counts, plan.displs, MPI_DOUBLE, 0, MPI_COMM_WORLD);
     comm_time += MPI_Wtime() - comm_start;
-    
+
     end_time = MPI_Wtime();
     total_time = end_time - start_time;
-    
+
     // Collect statistics
     double max_compute, min_compute, avg_compute;
     double max_comm, min_comm, avg_comm;
-    
+    double max_wait, max_reference;
+
     MPI_Reduce(&compute_time, &max_compute, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     MPI_Reduce(&compute_time, &min_compute, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
     MPI_Reduce(&compute_time, &avg_compute, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
     MPI_Reduce(&comm_time, &max_comm, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
     MPI_Reduce(&comm_time, &min_comm, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
     MPI_Reduce(&comm_time, &avg_comm, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-    
+    MPI_Reduce(&wait_time, &max_wait, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&reference_time, &max_reference, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
     if (rank == 0) {
         avg_compute /= num_procs;
         avg_comm /= num_procs;
-        
+
+        // Share of the blocking panel distribution that the pipeline hid behind compute
+        double overlap = (max_reference > 0.0) ? 1.0 - max_wait / max_reference : 0.0;
+        if (overlap < 0.0) overlap = 0.0;
+
         printf("Results:\n");
         printf("Total time: %.6f seconds\n", total_time);
         printf("\nComputation time:\n");
-        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n", 
+        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n",
                max_compute, min_compute, avg_compute);
         printf("Communication time:\n");
-        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n", 
+        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n",
                max_comm, min_comm, avg_comm);
-        printf("\nOverlap efficiency: %.2f%% (comm hidden by compute)\n",
-               (1.0 - (max_comm / total_time)) * 100.0);
+        printf("B panel wait (exposed): %.6f s max\n", max_wait);
+        printf("B panel broadcast without overlap (reference): %.6f s max\n", max_reference);
+        printf("\nOverlap efficiency: %.2f%% (1 - wait / reference)\n", overlap * 100.0);
         printf("Load balance: %.2f%%\n", (min_compute / max_compute) * 100.0);
-        
+
         printf("\nSample results:\n");
         printf("C[0][0] = %.2f\n", C[0]);
-        printf("C[%d][%d] = %.2f\n", 
+        printf("C[%d][%d] = %.2f\n",
                matrix_size-1, matrix_size-1, C[matrix_size*matrix_size-1]);
-        
+
         free(A);
+        free(B);
         free(C);
-        free(send_requests);
-        free(send_status);
-        free(recv_requests);
-        free(recv_status);
     }
-    
-    free(B);
+
     free(A_local);
     free(C_local);
-    
+    free(panels);
+    rp_free(&plan);
+
     MPI_Finalize();
     return 0;
 }
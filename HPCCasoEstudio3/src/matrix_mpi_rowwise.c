@@ -2,13 +2,16 @@
  * Matrix Multiplication - MPI Row-wise Distribution
  * Master distribuye filas de A a workers
  * Cada worker calcula su porción de C
- * Usa MPI_Scatter y MPI_Gather
+ * Usa MPI_Scatterv y MPI_Gatherv con el reparto de row_partition.h
+ * (iguales, por calibración de velocidad o por archivo de pesos; cualquier n)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <mpi.h>
 #include <time.h>
+#include "phase_timer.h"
+#include "row_partition.h"
 
 void initialize_matrix(double *matrix, int rows, int cols, int seed) {
     srand(seed);
@@ -35,6 +38,7 @@ int main(int argc, char *argv[]) {
     double *A = NULL, *B = NULL, *C = NULL;
     double *A_local = NULL, *B_local = NULL, *C_local = NULL;
     int local_rows;
+    rp_plan_t plan;
     double start_time, end_time, total_time;
     double comm_start, comm_time = 0.0, compute_time = 0.0;
     
@@ -42,9 +46,9 @@ int main(int argc, char *argv[]) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
     
-    if (argc != 2) {
+    if (argc < 2 || argc > 3) {
         if (rank == 0) {
-            printf("Uso: mpirun -np <procs> %s <matrix_size>\n", argv[0]);
+            printf("Uso: mpirun -np <procs> %s <matrix_size> [equal|calibrate|weights_file]\n", argv[0]);
         }
         MPI_Finalize();
         return 1;
@@ -52,45 +56,63 @@ int main(int argc, char *argv[]) {
     
     matrix_size = atoi(argv[1]);
     
-    if (matrix_size % num_procs != 0) {
+    if (matrix_size <= 0) {
         if (rank == 0) {
-            printf("Error: Matrix size must be divisible by number of processes\n");
-            printf("Matrix size: %d, Processes: %d\n", matrix_size, num_procs);
+            printf("Error: Matrix size must be positive\n");
         }
         MPI_Finalize();
         return 1;
     }
     
-    local_rows = matrix_size / num_procs;
+    // Rows per rank (calibration runs here, outside the timed region)
+    if (!rp_plan(&plan, matrix_size, (argc == 3) ? argv[2] : "equal", MPI_COMM_WORLD)) {
+        if (rank == 0) {
+            printf("Error: Could not read weights file %s\n", argv[2]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    local_rows = plan.rows[rank];
+    
+    // Phase record (written by rank 0 only)
+    pt_run_t run;
+    pt_init(&run, "matrix_mpi_rowwise");
+    pt_param(&run, "n", matrix_size);
+    pt_param(&run, "procs", num_procs);
     
     // Start total timing
     start_time = MPI_Wtime();
+    pt_begin(&run, "alloc");
     
     // Master process initializes matrices
     if (rank == 0) {
         printf("=== MPI Row-wise Distribution ===\n");
         printf("Matrix size: %d x %d\n", matrix_size, matrix_size);
         printf("Number of processes: %d\n", num_procs);
-        printf("Rows per process: %d\n\n", local_rows);
+        rp_print(&plan);
+        printf("\n");
         
         A = (double*)malloc(matrix_size * matrix_size * sizeof(double));
         B = (double*)malloc(matrix_size * matrix_size * sizeof(double));
         C = (double*)malloc(matrix_size * matrix_size * sizeof(double));
         
+        pt_begin(&run, "init");
         initialize_matrix(A, matrix_size, matrix_size, 12345);
         initialize_matrix(B, matrix_size, matrix_size, 54321);
     }
     
     // All processes allocate local buffers
-    A_local = (double*)malloc(local_rows * matrix_size * sizeof(double));
+    pt_begin(&run, "alloc");
+    A_local = (double*)malloc((local_rows * matrix_size + 1) * sizeof(double));
     B_local = (double*)malloc(matrix_size * matrix_size * sizeof(double));
-    C_local = (double*)malloc(local_rows * matrix_size * sizeof(double));
+    C_local = (double*)malloc((local_rows * matrix_size + 1) * sizeof(double));
     
-    // Distribute rows of A using Scatter
+    // Distribute rows of A using Scatterv (uneven counts)
+    pt_begin(&run, "distribute");
     comm_start = MPI_Wtime();
-    MPI_Scatter(A, local_rows * matrix_size, MPI_DOUBLE,
-                A_local, local_rows * matrix_size, MPI_DOUBLE,
-                0, MPI_COMM_WORLD);
+    MPI_Scatterv(A, plan.counts, plan.displs, MPI_DOUBLE,
+                 A_local, local_rows * matrix_size, MPI_DOUBLE,
+                 0, MPI_COMM_WORLD);
     comm_time += MPI_Wtime() - comm_start;
     
     // Broadcast entire matrix B to all processes
@@ -104,19 +126,22 @@ int main(int argc, char *argv[]) {
     comm_time += MPI_Wtime() - comm_start;
     
     // Local computation
+    pt_begin(&run, "compute");
     double comp_start = MPI_Wtime();
     matrix_multiply_rows(A_local, B_local, C_local, local_rows, matrix_size);
     compute_time = MPI_Wtime() - comp_start;
     
     // Gather results back to master
+    pt_begin(&run, "gather");
     comm_start = MPI_Wtime();
-    MPI_Gather(C_local, local_rows * matrix_size, MPI_DOUBLE,
-               C, local_rows * matrix_size, MPI_DOUBLE,
-               0, MPI_COMM_WORLD);
+    MPI_Gatherv(C_local, local_rows * matrix_size, MPI_DOUBLE,
+                C, plan.counts, plan.displs, MPI_DOUBLE,
+                0, MPI_COMM_WORLD);
     comm_time += MPI_Wtime() - comm_start;
     
     end_time = MPI_Wtime();
     total_time = end_time - start_time;
+    pt_end(&run);
     
     // Master prints results
     if (rank == 0) {
@@ -131,14 +156,18 @@ int main(int argc, char *argv[]) {
         printf("C[%d][%d] = %.2f\n", 
                matrix_size-1, matrix_size-1, C[matrix_size*matrix_size-1]);
         
+        pt_begin(&run, "teardown");
         free(A);
         free(B);
         free(C);
     }
     
+    if (rank != 0) pt_begin(&run, "teardown");
     free(A_local);
     free(B_local);
     free(C_local);
+    rp_free(&plan);
+    if (rank == 0) pt_emit(&run);
     
     MPI_Finalize();
     return 0;
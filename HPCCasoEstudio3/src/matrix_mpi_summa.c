@@ -0,0 +1,257 @@
+/*
+ * Matrix Multiplication - MPI SUMMA (malla 2D de procesos)
+ * Los procesos forman una malla pr x pc (MPI_Dims_create + MPI_Cart_create,
+ * admite mallas no cuadradas). A, B y C se reparten por bloques 2D: cada rango
+ * guarda solo su bloque de cada matriz, memoria O(n^2/P).
+ * En cada paso se difunde un panel de columnas de A por la fila de la malla y
+ * un panel de filas de B por la columna, y cada rango acumula el producto de
+ * los paneles en su bloque de C con un kernel por bloques.
+ * Cualquier n: los bloques difieren como mucho en una fila/columna.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+#include <time.h>
+
+#define DEFAULT_PANEL 64
+#define KERNEL_BLOCK_I 32
+#define KERNEL_BLOCK_J 256
+
+// First global index of block `b` when `n` is split into `parts` blocks
+int block_start(int n, int parts, int b) {
+    return (int)((long long)b * n / parts);
+}
+
+// Block that owns global index `g`
+int block_owner(int n, int parts, int g) {
+    int b = (int)(((long long)g * parts) / n);
+    while (block_start(n, parts, b + 1) <= g) b++;
+    while (block_start(n, parts, b) > g) b--;
+    return b;
+}
+
+// Fills the local block [r0,r1) x [c0,c1) with the same values that
+// initialize_matrix produces for the full matrix (rand() in row-major order),
+// without ever holding the full matrix
+void initialize_block(double *local, int n, int r0, int r1, int c0, int c1, int seed) {
+    int cols = c1 - c0;
+    srand(seed);
+    for (int i = 0; i < r1; i++) {
+        for (int j = 0; j < n; j++) {
+            int value = rand() % 100;
+            if (i >= r0 && j >= c0 && j < c1) {
+                local[(size_t)(i - r0) * cols + (j - c0)] = (double)value;
+            }
+        }
+    }
+}
+
+// C_local (rows x cols) += A_panel (rows x width) * B_panel (width x cols),
+// blocked over rows and columns so a strip of C and the panel of B stay in cache
+void panel_multiply(const double *A_panel, const double *B_panel, double *C_local,
+                    int rows, int cols, int width) {
+    for (int ii = 0; ii < rows; ii += KERNEL_BLOCK_I) {
+        int i_end = (ii + KERNEL_BLOCK_I < rows) ? ii + KERNEL_BLOCK_I : rows;
+        for (int jj = 0; jj < cols; jj += KERNEL_BLOCK_J) {
+            int j_end = (jj + KERNEL_BLOCK_J < cols) ? jj + KERNEL_BLOCK_J : cols;
+            for (int i = ii; i < i_end; i++) {
+                double *c_row = &C_local[(size_t)i * cols];
+                for (int k = 0; k < width; k++) {
+                    double a = A_panel[(size_t)i * width + k];
+                    const double *b_row = &B_panel[(size_t)k * cols];
+                    for (int j = jj; j < j_end; j++) {
+                        c_row[j] += a * b_row[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int rank, num_procs;
+    int matrix_size, panel;
+    double start_time, total_time;
+    double comm_start, comm_time = 0.0, compute_time = 0.0;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    if (argc < 2 || argc > 3) {
+        if (rank == 0) {
+            printf("Uso: mpirun -np <procs> %s <matrix_size> [panel_width]\n", argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    matrix_size = atoi(argv[1]);
+    panel = (argc == 3) ? atoi(argv[2]) : DEFAULT_PANEL;
+    if (matrix_size <= 0 || panel <= 0) {
+        if (rank == 0) {
+            printf("Error: Matrix size and panel width must be positive\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    // 2D process grid and its row/column sub-communicators
+    int dims[2] = {0, 0}, periods[2] = {0, 0}, coords[2];
+    MPI_Dims_create(num_procs, 2, dims);
+    MPI_Comm grid_comm, row_comm, col_comm;
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &grid_comm);
+    MPI_Comm_rank(grid_comm, &rank);
+    MPI_Cart_coords(grid_comm, rank, 2, coords);
+    int keep_cols[2] = {0, 1}, keep_rows[2] = {1, 0};
+    MPI_Cart_sub(grid_comm, keep_cols, &row_comm);   // Same grid row, rank = grid column
+    MPI_Cart_sub(grid_comm, keep_rows, &col_comm);   // Same grid column, rank = grid row
+
+    int pr = dims[0], pc = dims[1];
+    int my_row = coords[0], my_col = coords[1];
+    int r0 = block_start(matrix_size, pr, my_row), r1 = block_start(matrix_size, pr, my_row + 1);
+    int c0 = block_start(matrix_size, pc, my_col), c1 = block_start(matrix_size, pc, my_col + 1);
+    int local_rows = r1 - r0, local_cols = c1 - c0;
+
+    if (rank == 0) {
+        printf("=== MPI SUMMA (2D grid) ===\n");
+        printf("Matrix size: %d x %d\n", matrix_size, matrix_size);
+        printf("Number of processes: %d\n", num_procs);
+        printf("Process grid: %d x %d\n", pr, pc);
+        printf("Panel width: %d\n", panel);
+        printf("Block per process: up to %d x %d\n\n",
+               block_start(matrix_size, pr, 1), block_start(matrix_size, pc, 1));
+    }
+
+    // Local blocks of A (r0:r1, c0:c1), B (r0:r1, c0:c1) and C, plus the two panels
+    size_t block_elems = (size_t)local_rows * local_cols;
+    double *A_local = (double*)malloc((block_elems > 0 ? block_elems : 1) * sizeof(double));
+    double *B_local = (double*)malloc((block_elems > 0 ? block_elems : 1) * sizeof(double));
+    double *C_local = (double*)calloc(block_elems > 0 ? block_elems : 1, sizeof(double));
+    double *A_panel = (double*)malloc(((size_t)local_rows * panel + 1) * sizeof(double));
+    double *B_panel = (double*)malloc(((size_t)panel * local_cols + 1) * sizeof(double));
+    if (!A_local || !B_local || !C_local || !A_panel || !B_panel) {
+        fprintf(stderr, "Rank %d: out of memory\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    initialize_block(A_local, matrix_size, r0, r1, c0, c1, 12345);
+    initialize_block(B_local, matrix_size, r0, r1, c0, c1, 54321);
+    double local_mb = (3.0 * block_elems + (double)local_rows * panel + (double)panel * local_cols)
+                      * sizeof(double) / (1024.0 * 1024.0);
+
+    MPI_Barrier(grid_comm);
+    start_time = MPI_Wtime();
+
+    // Panels never cross a block boundary of A's columns (pc) or B's rows (pr)
+    int steps = 0;
+    for (int k0 = 0; k0 < matrix_size; ) {
+        int owner_col = block_owner(matrix_size, pc, k0);
+        int owner_row = block_owner(matrix_size, pr, k0);
+        int k1 = k0 + panel;
+        if (k1 > block_start(matrix_size, pc, owner_col + 1)) k1 = block_start(matrix_size, pc, owner_col + 1);
+        if (k1 > block_start(matrix_size, pr, owner_row + 1)) k1 = block_start(matrix_size, pr, owner_row + 1);
+        int width = k1 - k0;
+
+        // Pack columns k0:k1 of A (owner column) and rows k0:k1 of B (owner row)
+        if (my_col == owner_col) {
+            for (int i = 0; i < local_rows; i++) {
+                memcpy(&A_panel[(size_t)i * width], &A_local[(size_t)i * local_cols + (k0 - c0)],
+                       width * sizeof(double));
+            }
+        }
+        if (my_row == owner_row) {
+            memcpy(B_panel, &B_local[(size_t)(k0 - r0) * local_cols], (size_t)width * local_cols * sizeof(double));
+        }
+
+        comm_start = MPI_Wtime();
+        MPI_Bcast(A_panel, local_rows * width, MPI_DOUBLE, owner_col, row_comm);
+        MPI_Bcast(B_panel, width * local_cols, MPI_DOUBLE, owner_row, col_comm);
+        comm_time += MPI_Wtime() - comm_start;
+
+        double comp_start = MPI_Wtime();
+        panel_multiply(A_panel, B_panel, C_local, local_rows, local_cols, width);
+        compute_time += MPI_Wtime() - comp_start;
+
+        k0 = k1;
+        steps++;
+    }
+
+    total_time = MPI_Wtime() - start_time;
+
+    // Checksum: sum(C) must equal sum_k colsum_A[k] * rowsum_B[k]
+    double local_sum = 0.0, c_sum = 0.0, expected = 0.0;
+    for (size_t e = 0; e < block_elems; e++) local_sum += C_local[e];
+    MPI_Reduce(&local_sum, &c_sum, 1, MPI_DOUBLE, MPI_SUM, 0, grid_comm);
+    double *colsum_A = (double*)calloc(matrix_size, sizeof(double));
+    double *rowsum_B = (double*)calloc(matrix_size, sizeof(double));
+    for (int i = 0; i < local_rows; i++) {
+        for (int j = 0; j < local_cols; j++) {
+            colsum_A[c0 + j] += A_local[(size_t)i * local_cols + j];
+            rowsum_B[r0 + i] += B_local[(size_t)i * local_cols + j];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, colsum_A, matrix_size, MPI_DOUBLE, MPI_SUM, grid_comm);
+    MPI_Allreduce(MPI_IN_PLACE, rowsum_B, matrix_size, MPI_DOUBLE, MPI_SUM, grid_comm);
+    for (int k = 0; k < matrix_size; k++) expected += colsum_A[k] * rowsum_B[k];
+
+    // Corner samples: C[0][0] lives on grid (0,0), C[n-1][n-1] on grid (pr-1,pc-1)
+    double last = 0.0;
+    int last_coords[2] = {pr - 1, pc - 1}, last_rank;
+    MPI_Cart_rank(grid_comm, last_coords, &last_rank);
+    if (rank == last_rank && block_elems > 0) last = C_local[block_elems - 1];
+    MPI_Bcast(&last, 1, MPI_DOUBLE, last_rank, grid_comm);
+
+    // Collect timing statistics from all processes
+    double max_compute, min_compute, avg_compute;
+    double max_comm, min_comm, avg_comm, max_mb;
+    MPI_Reduce(&compute_time, &max_compute, 1, MPI_DOUBLE, MPI_MAX, 0, grid_comm);
+    MPI_Reduce(&compute_time, &min_compute, 1, MPI_DOUBLE, MPI_MIN, 0, grid_comm);
+    MPI_Reduce(&compute_time, &avg_compute, 1, MPI_DOUBLE, MPI_SUM, 0, grid_comm);
+    MPI_Reduce(&comm_time, &max_comm, 1, MPI_DOUBLE, MPI_MAX, 0, grid_comm);
+    MPI_Reduce(&comm_time, &min_comm, 1, MPI_DOUBLE, MPI_MIN, 0, grid_comm);
+    MPI_Reduce(&comm_time, &avg_comm, 1, MPI_DOUBLE, MPI_SUM, 0, grid_comm);
+    MPI_Reduce(&local_mb, &max_mb, 1, MPI_DOUBLE, MPI_MAX, 0, grid_comm);
+
+    if (rank == 0) {
+        avg_compute /= num_procs;
+        avg_comm /= num_procs;
+
+        printf("Results:\n");
+        printf("Total time: %.6f seconds\n", total_time);
+        printf("SUMMA steps: %d\n", steps);
+        printf("\nComputation time:\n");
+        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n",
+               max_compute, min_compute, avg_compute);
+        printf("Communication time:\n");
+        printf("  Max: %.6f s  Min: %.6f s  Avg: %.6f s\n",
+               max_comm, min_comm, avg_comm);
+        printf("\nLoad balance: %.2f%% (min/max compute)\n",
+               (min_compute / max_compute) * 100.0);
+        printf("Comm overhead: %.2f%% of total time\n",
+               (max_comm / total_time) * 100.0);
+        printf("Per-rank memory: %.2f MB max (full matrix: %.2f MB)\n", max_mb,
+               (double)matrix_size * matrix_size * sizeof(double) / (1024.0 * 1024.0));
+
+        printf("\nSample results:\n");
+        printf("C[0][0] = %.2f\n", block_elems > 0 ? C_local[0] : 0.0);
+        printf("C[%d][%d] = %.2f\n", matrix_size-1, matrix_size-1, last);
+        printf("Checksum: %.0f (expected %.0f) %s\n", c_sum, expected,
+               c_sum == expected ? "✓" : "✗");
+    }
+
+    free(colsum_A);
+    free(rowsum_B);
+    free(A_local);
+    free(B_local);
+    free(C_local);
+    free(A_panel);
+    free(B_panel);
+    MPI_Comm_free(&row_comm);
+    MPI_Comm_free(&col_comm);
+    MPI_Comm_free(&grid_comm);
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,269 @@
+/*
+ * phase_timer.h - Medición por fases con contabilidad correcta de tiempos
+ *
+ * Una ejecución se divide en fases con nombre (alloc, init, compute, verify,
+ * teardown, ...). Para cada fase se guarda la diferencia entre dos muestras:
+ *   - wall:        CLOCK_MONOTONIC (no salta con ajustes del reloj)
+ *   - main_cpu:    CLOCK_THREAD_CPUTIME_ID del hilo que mide (solo ese hilo:
+ *                  en un pool queda casi en 0 mientras los trabajadores calculan)
+ *   - worker_cpu:  CPU de cada trabajador registrado con pt_watch_threads
+ *                  (hilos, vía pthread_getcpuclockid) o pt_watch_processes
+ *                  (procesos hijos, vía clock_getcpuclockid). Cuando un
+ *                  trabajador termina se conserva su último valor leído
+ *   - user / sys:  getrusage(RUSAGE_SELF), suma de todos los hilos del proceso
+ *   - child_user / child_sys: getrusage(RUSAGE_CHILDREN); solo incluye hijos
+ *                  ya recogidos con wait(), así que en el pool de procesos
+ *                  aparece en la fase donde se destruye el pool
+ *   - vcsw / ivcsw: cambios de contexto voluntarios e involuntarios
+ *   - minflt / majflt: fallos de página menores y mayores
+ *
+ * clock() mide tiempo de CPU del proceso (todos los hilos sumados), no tiempo
+ * de pared: con p hilos ocupados crece p veces más rápido y el speedup parece
+ * cercano a 1. Para tiempos de pared usar pt_now().
+ *
+ * pt_emit añade una línea JSON por ejecución al archivo de la variable de
+ * entorno PHASE_LOG (por defecto "phases.jsonl"). PHASE_LOG="" desactiva el
+ * registro; PHASE_LOG="-" escribe en stdout.
+ *
+ * Requiere _POSIX_C_SOURCE >= 200112L (o _DEFAULT_SOURCE/_GNU_SOURCE) antes del
+ * primer #include cuando se compila con -std=c99, y enlazar con pthread.
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#define PT_DEFAULT_LOG "phases.jsonl"
+#define PT_MAX_PHASES 16
+#define PT_MAX_PARAMS 8
+#define PT_NAME_MAX 32
+#define PT_MAX_WORKERS 64
+
+typedef struct {
+    double wall;
+    double main_cpu;
+    double worker_cpu[PT_MAX_WORKERS];
+    double user, sys;
+    double child_user, child_sys;
+    long vcsw, ivcsw;
+    long minflt, majflt;
+} pt_sample_t;
+
+typedef struct {
+    char name[PT_NAME_MAX];
+    int count;                   // Veces que se abrió la fase (se acumulan)
+    pt_sample_t total;
+} pt_phase_t;
+
+typedef struct {
+    char program[PT_NAME_MAX];
+    int num_phases;
+    pt_phase_t phases[PT_MAX_PHASES];
+    int num_params;
+    char param_names[PT_MAX_PARAMS][PT_NAME_MAX];
+    long long param_values[PT_MAX_PARAMS];
+    int open;                    // Índice de la fase abierta, -1 si ninguna
+    int num_workers;             // Trabajadores registrados (0: sin worker_cpu)
+    clockid_t worker_clocks[PT_MAX_WORKERS];
+    double worker_last[PT_MAX_WORKERS];  // Último valor leído de cada reloj
+    pt_sample_t open_start;
+    pt_sample_t run_start;
+    pt_sample_t run_total;
+} pt_run_t;
+
+static inline double pt_clock(clockid_t id) {
+    struct timespec ts;
+    clock_gettime(id, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Tiempo de pared monotónico en segundos
+static inline double pt_now(void) {
+    return pt_clock(CLOCK_MONOTONIC);
+}
+
+static inline double pt_tv(struct timeval tv) {
+    return (double)tv.tv_sec + (double)tv.tv_usec * 1e-6;
+}
+
+static inline void pt_sample(pt_run_t *run, pt_sample_t *s) {
+    struct rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+    s->wall = pt_now();
+    s->main_cpu = pt_clock(CLOCK_THREAD_CPUTIME_ID);
+    for (int w = 0; w < run->num_workers; w++) {
+        struct timespec ts;
+        if (clock_gettime(run->worker_clocks[w], &ts) == 0) {
+            run->worker_last[w] = (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+        }
+        s->worker_cpu[w] = run->worker_last[w];
+    }
+    s->user = pt_tv(self.ru_utime);
+    s->sys = pt_tv(self.ru_stime);
+    s->child_user = pt_tv(children.ru_utime);
+    s->child_sys = pt_tv(children.ru_stime);
+    s->vcsw = self.ru_nvcsw;
+    s->ivcsw = self.ru_nivcsw;
+    s->minflt = self.ru_minflt;
+    s->majflt = self.ru_majflt;
+}
+
+// acc += end - start
+static inline void pt_accumulate(pt_sample_t *acc, const pt_sample_t *start, const pt_sample_t *end) {
+    acc->wall += end->wall - start->wall;
+    acc->main_cpu += end->main_cpu - start->main_cpu;
+    for (int w = 0; w < PT_MAX_WORKERS; w++) {
+        acc->worker_cpu[w] += end->worker_cpu[w] - start->worker_cpu[w];
+    }
+    acc->user += end->user - start->user;
+    acc->sys += end->sys - start->sys;
+    acc->child_user += end->child_user - start->child_user;
+    acc->child_sys += end->child_sys - start->child_sys;
+    acc->vcsw += end->vcsw - start->vcsw;
+    acc->ivcsw += end->ivcsw - start->ivcsw;
+    acc->minflt += end->minflt - start->minflt;
+    acc->majflt += end->majflt - start->majflt;
+}
+
+static inline void pt_init(pt_run_t *run, const char *program) {
+    memset(run, 0, sizeof(*run));
+    snprintf(run->program, sizeof(run->program), "%s", program);
+    run->open = -1;
+    pt_sample(run, &run->run_start);
+}
+
+// Añade un reloj de CPU de trabajador; los valores previos de las muestras ya
+// tomadas se igualan al actual para que las fases abiertas no cuenten el pasado
+static inline void pt_watch_clock(pt_run_t *run, clockid_t clock) {
+    struct timespec ts;
+    int w = run->num_workers;
+    if (w >= PT_MAX_WORKERS || clock_gettime(clock, &ts) != 0) return;
+    double now = (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+    run->worker_clocks[w] = clock;
+    run->worker_last[w] = now;
+    run->run_start.worker_cpu[w] = now;
+    run->open_start.worker_cpu[w] = now;
+    run->num_workers++;
+}
+
+// Registra hilos de un pool (p. ej. tp_pool_t.threads) para medir su CPU por fase
+static inline void pt_watch_threads(pt_run_t *run, const pthread_t *threads, int count) {
+    for (int t = 0; t < count; t++) {
+        clockid_t clock;
+        if (pthread_getcpuclockid(threads[t], &clock) == 0) pt_watch_clock(run, clock);
+    }
+}
+
+// Registra procesos hijos (p. ej. pp_pool_t.pids) para medir su CPU por fase
+static inline void pt_watch_processes(pt_run_t *run, const pid_t *pids, int count) {
+    for (int p = 0; p < count; p++) {
+        clockid_t clock;
+        if (pids[p] > 0 && clock_getcpuclockid(pids[p], &clock) == 0) pt_watch_clock(run, clock);
+    }
+}
+
+// Parámetro entero de la ejecución (n, hilos, procesos, ...)
+static inline void pt_param(pt_run_t *run, const char *name, long long value) {
+    if (run->num_params >= PT_MAX_PARAMS) return;
+    snprintf(run->param_names[run->num_params], PT_NAME_MAX, "%s", name);
+    run->param_values[run->num_params++] = value;
+}
+
+// Cierra la fase abierta, si hay una
+static inline void pt_end(pt_run_t *run) {
+    if (run->open < 0) return;
+    pt_sample_t now;
+    pt_sample(run, &now);
+    pt_accumulate(&run->phases[run->open].total, &run->open_start, &now);
+    run->open = -1;
+}
+
+// Abre la fase `name` (cerrando la anterior). Repetir un nombre acumula.
+static inline void pt_begin(pt_run_t *run, const char *name) {
+    pt_end(run);
+    int p = 0;
+    while (p < run->num_phases && strcmp(run->phases[p].name, name) != 0) p++;
+    if (p == run->num_phases) {
+        if (p >= PT_MAX_PHASES) return;
+        snprintf(run->phases[p].name, PT_NAME_MAX, "%s", name);
+        run->num_phases++;
+    }
+    run->phases[p].count++;
+    run->open = p;
+    pt_sample(run, &run->open_start);
+}
+
+// Tiempo de pared acumulado de una fase; 0 si no existe
+static inline double pt_phase_wall(const pt_run_t *run, const char *name) {
+    for (int p = 0; p < run->num_phases; p++) {
+        if (strcmp(run->phases[p].name, name) == 0) return run->phases[p].total.wall;
+    }
+    return 0.0;
+}
+
+static inline void pt_write_sample(FILE *f, const pt_sample_t *s, int num_workers) {
+    fprintf(f, "\"wall_s\":%.9f,\"main_cpu_s\":%.9f,\"user_s\":%.6f,\"sys_s\":%.6f,"
+               "\"child_user_s\":%.6f,\"child_sys_s\":%.6f,\"vcsw\":%ld,\"ivcsw\":%ld,"
+               "\"minflt\":%ld,\"majflt\":%ld",
+            s->wall, s->main_cpu, s->user, s->sys, s->child_user, s->child_sys,
+            s->vcsw, s->ivcsw, s->minflt, s->majflt);
+    if (num_workers > 0) {
+        fprintf(f, ",\"worker_cpu_s\":[");
+        for (int w = 0; w < num_workers; w++) {
+            fprintf(f, "%s%.9f", w ? "," : "", s->worker_cpu[w]);
+        }
+        fprintf(f, "]");
+    }
+}
+
+// Cierra la fase abierta y escribe el registro de la ejecución. 0 si falla.
+static inline int pt_emit(pt_run_t *run) {
+    pt_end(run);
+    pt_sample_t now;
+    pt_sample(run, &now);
+    memset(&run->run_total, 0, sizeof(run->run_total));
+    pt_accumulate(&run->run_total, &run->run_start, &now);
+
+    const char *path = getenv("PHASE_LOG");
+    if (path == NULL) path = PT_DEFAULT_LOG;
+    if (path[0] == '\0') return 1;
+    FILE *f = (strcmp(path, "-") == 0) ? stdout : fopen(path, "a");
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+
+    fprintf(f, "{\"program\":\"%s\",\"pid\":%ld,\"timestamp\":%ld,\"params\":{",
+            run->program, (long)getpid(), (long)time(NULL));
+    for (int i = 0; i < run->num_params; i++) {
+        fprintf(f, "%s\"%s\":%lld", i ? "," : "", run->param_names[i], run->param_values[i]);
+    }
+    fprintf(f, "},\"phases\":[");
+    for (int p = 0; p < run->num_phases; p++) {
+        fprintf(f, "%s{\"name\":\"%s\",\"count\":%d,", p ? "," : "",
+                run->phases[p].name, run->phases[p].count);
+        pt_write_sample(f, &run->phases[p].total, run->num_workers);
+        fprintf(f, "}");
+    }
+    fprintf(f, "],\"total\":{");
+    pt_write_sample(f, &run->run_total, run->num_workers);
+    fprintf(f, "}}\n");
+
+    if (f == stdout) {
+        fflush(f);
+        return 1;
+    }
+    return fclose(f) == 0;
+}
+
+#endif
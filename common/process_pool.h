@@ -0,0 +1,266 @@
+/*
+ * process_pool.h - Pool de procesos pre-creados con anillo de trabajos compartido
+ *
+ * pp_create hace fork() de los trabajadores una sola vez. Cada hijo espera en
+ * un anillo de descriptores de trabajo (fn, arg, begin, end) en memoria
+ * mmap(MAP_SHARED), sincronizado con semáforos POSIX compartidos entre procesos:
+ * `items` cuenta trabajos publicados, `space` huecos libres y `done` trabajos
+ * terminados. El padre publica y espera; los hijos no terminan entre
+ * multiplicaciones, así que el costo de fork/exit y de copiar tablas de páginas
+ * queda fuera de la medición.
+ *
+ * Los hijos solo ven memoria compartida creada antes del fork. Por eso el pool
+ * incluye una arena compartida: A, B, C y los argumentos de los trabajos se
+ * toman de ella con pp_arena_alloc y se reutilizan entre llamadas
+ * (pp_arena_reset). fn es válida en los hijos porque no hay exec: la imagen del
+ * programa es la misma. Al arrancar, cada hijo lee una vez cada página de la
+ * arena para tener sus entradas de tabla de páginas antes del primer trabajo.
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef PROCESS_POOL_H
+#define PROCESS_POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#define PP_RING_CAP 256
+#define PP_ALIGN 64
+#define PP_POLL_NS 100000000L    // Cada 100 ms se comprueba que los hijos sigan vivos
+
+// Cuerpo de un trabajo: procesa [begin, end); arg debe estar en memoria compartida
+typedef void (*pp_job_fn)(void *arg, int begin, int end);
+
+// Se ejecuta una vez en cada hijo al arrancar (p. ej. para fijar afinidad)
+typedef void (*pp_init_fn)(void *arg, int worker);
+
+typedef struct {
+    pp_job_fn fn;                // NULL: el hijo termina
+    void *arg;
+    int begin;
+    int end;
+} pp_job_t;
+
+typedef struct {
+    sem_t items;                 // Trabajos publicados y no tomados
+    sem_t space;                 // Huecos libres del anillo
+    sem_t done;                  // Trabajos terminados (y arranques de hijos)
+    pthread_mutex_t take;        // Tomar y copiar un trabajo en orden
+    unsigned head;               // Próximo a tomar (bajo `take`)
+    unsigned tail;               // Próximo a publicar (solo el padre)
+    pp_job_t ring[PP_RING_CAP];
+} pp_shared_t;
+
+typedef struct {
+    int num_workers;
+    pid_t *pids;
+    pp_shared_t *shared;
+    char *arena;
+    size_t arena_cap;
+    size_t arena_used;
+    long long outstanding;       // Trabajos publicados sin confirmar (solo el padre)
+} pp_pool_t;
+
+static inline void pp_worker_main(pp_pool_t *pool, int worker, pp_init_fn init, void *init_arg) {
+    pp_shared_t *sh = pool->shared;
+    long page = sysconf(_SC_PAGESIZE);
+    if (init != NULL) init(init_arg, worker);
+    for (size_t off = 0; off < pool->arena_cap; off += (size_t)page) {
+        (void)*(volatile char*)(pool->arena + off);
+    }
+    sem_post(&sh->done);
+
+    for (;;) {
+        while (sem_wait(&sh->items) != 0) { }
+        pthread_mutex_lock(&sh->take);
+        pp_job_t job = sh->ring[sh->head % PP_RING_CAP];
+        sh->head++;
+        pthread_mutex_unlock(&sh->take);
+        sem_post(&sh->space);
+
+        if (job.fn == NULL) _exit(0);
+        job.fn(job.arg, job.begin, job.end);
+        sem_post(&sh->done);
+    }
+}
+
+// 1 si algún hijo terminó (no debería ocurrir antes de pp_destroy)
+static inline int pp_worker_died(pp_pool_t *pool) {
+    for (int w = 0; w < pool->num_workers; w++) {
+        if (pool->pids[w] < 0) return 1;
+        if (pool->pids[w] > 0 && waitpid(pool->pids[w], NULL, WNOHANG) == pool->pids[w]) {
+            pool->pids[w] = -1;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// sem_wait que no se bloquea para siempre si un hijo murió; 0 en ese caso
+static inline int pp_sem_wait_alive(pp_pool_t *pool, sem_t *sem) {
+    for (;;) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += PP_POLL_NS;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+        if (sem_timedwait(sem, &ts) == 0) return 1;
+        if (errno == ETIMEDOUT && pp_worker_died(pool)) return 0;
+    }
+}
+
+static inline void pp_free(pp_pool_t *pool) {
+    if (pool->shared != NULL && pool->shared != MAP_FAILED) {
+        sem_destroy(&pool->shared->items);
+        sem_destroy(&pool->shared->space);
+        sem_destroy(&pool->shared->done);
+        pthread_mutex_destroy(&pool->shared->take);
+        munmap(pool->shared, sizeof(pp_shared_t));
+    }
+    if (pool->arena != NULL && pool->arena != MAP_FAILED) munmap(pool->arena, pool->arena_cap);
+    free(pool->pids);
+    free(pool);
+}
+
+// Detiene los hijos y libera el pool y su arena
+static inline void pp_destroy(pp_pool_t *pool) {
+    if (pool == NULL) return;
+    int alive = 1;
+    for (int w = 0; w < pool->num_workers && alive; w++) {
+        alive = pp_sem_wait_alive(pool, &pool->shared->space);
+        if (alive) {
+            pp_job_t *slot = &pool->shared->ring[pool->shared->tail % PP_RING_CAP];
+            slot->fn = NULL;
+            pool->shared->tail++;
+            sem_post(&pool->shared->items);
+        }
+    }
+    for (int w = 0; w < pool->num_workers; w++) {
+        if (pool->pids[w] <= 0) continue;
+        if (!alive) kill(pool->pids[w], SIGTERM);
+        waitpid(pool->pids[w], NULL, 0);
+    }
+    pp_free(pool);
+}
+
+// Crea num_workers procesos y una arena compartida de arena_bytes; init(init_arg, w),
+// si no es NULL, corre en cada hijo al arrancar. Espera a que todos estén listos.
+// NULL si falla.
+static inline pp_pool_t* pp_create_ex(int num_workers, size_t arena_bytes, pp_init_fn init, void *init_arg) {
+    pp_pool_t *pool = (pp_pool_t*)calloc(1, sizeof(pp_pool_t));
+    if (pool == NULL || num_workers <= 0) {
+        free(pool);
+        return NULL;
+    }
+    pool->num_workers = num_workers;
+    pool->pids = (pid_t*)calloc(num_workers, sizeof(pid_t));
+    pool->shared = (pp_shared_t*)mmap(NULL, sizeof(pp_shared_t), PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pool->arena_cap = arena_bytes;
+    if (arena_bytes > 0) {
+        pool->arena = (char*)mmap(NULL, arena_bytes, PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    }
+    if (pool->pids == NULL || pool->shared == MAP_FAILED || pool->arena == MAP_FAILED) {
+        perror("pp_create");
+        pp_free(pool);
+        return NULL;
+    }
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&pool->shared->take, &attr);
+    pthread_mutexattr_destroy(&attr);
+    sem_init(&pool->shared->items, 1, 0);
+    sem_init(&pool->shared->space, 1, PP_RING_CAP);
+    sem_init(&pool->shared->done, 1, 0);
+
+    // Sin esto los hijos heredan la salida pendiente del padre y la repiten
+    fflush(NULL);
+    for (int w = 0; w < num_workers; w++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            pool->num_workers = w;
+            pp_destroy(pool);
+            return NULL;
+        }
+        if (pid == 0) pp_worker_main(pool, w, init, init_arg);
+        pool->pids[w] = pid;
+    }
+    for (int w = 0; w < num_workers; w++) {
+        if (!pp_sem_wait_alive(pool, &pool->shared->done)) {
+            pp_destroy(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+static inline pp_pool_t* pp_create(int num_workers, size_t arena_bytes) {
+    return pp_create_ex(num_workers, arena_bytes, NULL, NULL);
+}
+
+// Publica un trabajo; 0 si un hijo murió
+static inline int pp_submit(pp_pool_t *pool, pp_job_fn fn, void *arg, int begin, int end) {
+    if (!pp_sem_wait_alive(pool, &pool->shared->space)) return 0;
+    pp_job_t *slot = &pool->shared->ring[pool->shared->tail % PP_RING_CAP];
+    slot->fn = fn;
+    slot->arg = arg;
+    slot->begin = begin;
+    slot->end = end;
+    pool->shared->tail++;
+    pool->outstanding++;
+    sem_post(&pool->shared->items);
+    return 1;
+}
+
+// Espera a que terminen todos los trabajos publicados; 0 si un hijo murió
+static inline int pp_wait(pp_pool_t *pool) {
+    while (pool->outstanding > 0) {
+        if (!pp_sem_wait_alive(pool, &pool->shared->done)) return 0;
+        pool->outstanding--;
+    }
+    return 1;
+}
+
+// Igual que tp_parallel_for: [begin, end) en trozos de `grain`, y espera
+static inline int pp_parallel_for(pp_pool_t *pool, int begin, int end, int grain, pp_job_fn fn, void *arg) {
+    if (grain <= 0) grain = 1;
+    for (int b = begin; b < end; b += grain) {
+        if (!pp_submit(pool, fn, arg, b, (b + grain < end) ? b + grain : end)) return 0;
+    }
+    return pp_wait(pool);
+}
+
+// Reserva bytes de la arena compartida (alineados a 64); NULL si no caben
+static inline void* pp_arena_alloc(pp_pool_t *pool, size_t bytes) {
+    size_t start = (pool->arena_used + PP_ALIGN - 1) & ~(size_t)(PP_ALIGN - 1);
+    if (start + bytes > pool->arena_cap) return NULL;
+    pool->arena_used = start + bytes;
+    return pool->arena + start;
+}
+
+// Vuelve a usar la arena desde el principio (sin trabajos en curso)
+static inline void pp_arena_reset(pp_pool_t *pool) {
+    pool->arena_used = 0;
+}
+
+// Tamaño de arena para `count` bloques de hasta `bytes` cada uno
+static inline size_t pp_arena_bytes(size_t bytes, int count) {
+    return (size_t)count * ((bytes + PP_ALIGN - 1) & ~(size_t)(PP_ALIGN - 1));
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * reference_cache.h - Caché en disco de resultados de referencia
+ *
+ * Guarda, para cada combinación (n, semilla_A, semilla_B, tipo), la suma de
+ * verificación del resultado secuencial y un hash por fila de C. El nombre
+ * del archivo es el hash FNV-1a de la clave (direccionado por contenido) y la
+ * clave completa se guarda en la primera línea para descartar colisiones.
+ *
+ * El tiempo de pared secuencial va en un archivo aparte, con un segundo hash
+ * de su origen: host, ruta del ejecutable y mtime/tamaño del binario. Otro
+ * host, otro programa o una recompilación (otros CFLAGS) no encuentran ese
+ * tiempo y vuelven a medir; los hashes sí se comparten.
+ *
+ * Directorio: variable de entorno REF_CACHE_DIR (por defecto ".ref_cache").
+ * REF_CACHE_DIR="" desactiva la caché.
+ *
+ * Requiere _DEFAULT_SOURCE (o _GNU_SOURCE) antes del primer #include cuando se
+ * compila con -std=c99 (gethostname, readlink).
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef REFERENCE_CACHE_H
+#define REFERENCE_CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define REF_CACHE_DEFAULT_DIR ".ref_cache"
+#define REF_CACHE_PATH_MAX 512
+#define REF_CACHE_ORIGIN_MAX (REF_CACHE_PATH_MAX + 128)
+
+typedef struct {
+    int n;
+    int seed_a;
+    int seed_b;
+    char type[16];          // "int", "double", ...
+    long long checksum;     // Suma de C (para double: suma truncada a entero)
+    double seq_wall;        // Tiempo de pared de la versión secuencial
+    uint64_t *row_hash;     // n hashes, uno por fila de C
+} ref_entry_t;
+
+// FNV-1a de 64 bits
+static inline uint64_t ref_fnv1a(const void *data, size_t len, uint64_t h) {
+    const unsigned char *p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Hash de una fila de enteros
+static inline uint64_t ref_row_hash_int(const int *row, int n) {
+    return ref_fnv1a(row, (size_t)n * sizeof(int), 1469598103934665603ULL);
+}
+
+// Hash de una fila de doubles
+static inline uint64_t ref_row_hash_double(const double *row, int n) {
+    return ref_fnv1a(row, (size_t)n * sizeof(double), 1469598103934665603ULL);
+}
+
+static inline int ref_entry_init(ref_entry_t *e, int n, int seed_a, int seed_b, const char *type) {
+    e->n = n;
+    e->seed_a = seed_a;
+    e->seed_b = seed_b;
+    snprintf(e->type, sizeof(e->type), "%s", type);
+    e->checksum = 0;
+    e->seq_wall = 0.0;
+    e->row_hash = (uint64_t*)calloc((size_t)n, sizeof(uint64_t));
+    return e->row_hash != NULL;
+}
+
+static inline void ref_entry_free(ref_entry_t *e) {
+    free(e->row_hash);
+    e->row_hash = NULL;
+}
+
+// Directorio de la caché, o NULL si está desactivada
+static inline const char* ref_cache_dir(void) {
+    const char *dir = getenv("REF_CACHE_DIR");
+    if (dir == NULL) return REF_CACHE_DEFAULT_DIR;
+    if (dir[0] == '\0') return NULL;
+    return dir;
+}
+
+// v=2: el tiempo ya no va en el archivo de hashes
+static inline void ref_cache_key(const ref_entry_t *e, char *key, size_t len) {
+    snprintf(key, len, "v=2;n=%d;seed_a=%d;seed_b=%d;type=%s", e->n, e->seed_a, e->seed_b, e->type);
+}
+
+// Origen del tiempo medido: host y binario (ruta, mtime y tamaño)
+static inline void ref_cache_origin(char *origin, size_t len) {
+    char host[256] = "?", exe[REF_CACHE_PATH_MAX] = "?";
+    struct stat st;
+    memset(&st, 0, sizeof(st));
+    gethostname(host, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    ssize_t r = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (r > 0) {
+        exe[r] = '\0';
+        stat(exe, &st);
+    }
+    snprintf(origin, len, "host=%s;exe=%s;mtime=%lld;size=%lld", host, exe,
+             (long long)st.st_mtime, (long long)st.st_size);
+}
+
+// Archivo de hashes (<clave>.ref) o, con origin, archivo de tiempo (<clave>.<origen>.time)
+static inline int ref_cache_path(const ref_entry_t *e, const char *origin, char *path, size_t len) {
+    const char *dir = ref_cache_dir();
+    char key[128];
+    if (dir == NULL) return 0;
+    ref_cache_key(e, key, sizeof(key));
+    uint64_t h = ref_fnv1a(key, strlen(key), 1469598103934665603ULL);
+    if (origin == NULL) {
+        snprintf(path, len, "%s/%016llx.ref", dir, (unsigned long long)h);
+    } else {
+        uint64_t o = ref_fnv1a(origin, strlen(origin), 1469598103934665603ULL);
+        snprintf(path, len, "%s/%016llx.%016llx.time", dir, (unsigned long long)h, (unsigned long long)o);
+    }
+    return 1;
+}
+
+// Lee una línea sin el salto final; 1 si coincide con expected
+static inline int ref_cache_line_is(FILE *f, const char *expected) {
+    char line[REF_CACHE_ORIGIN_MAX];
+    if (fgets(line, sizeof(line), f) == NULL) return 0;
+    line[strcspn(line, "\n")] = '\0';
+    return strcmp(line, expected) == 0;
+}
+
+// Tiempo secuencial medido por este binario en este host; 1 si existe
+static inline int ref_cache_load_timing(ref_entry_t *e) {
+    char path[REF_CACHE_PATH_MAX], key[128], origin[REF_CACHE_ORIGIN_MAX];
+    ref_cache_origin(origin, sizeof(origin));
+    if (!ref_cache_path(e, origin, path, sizeof(path))) return 0;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+
+    ref_cache_key(e, key, sizeof(key));
+    int ok = ref_cache_line_is(f, key) && ref_cache_line_is(f, origin)
+          && fscanf(f, "%lf", &e->seq_wall) == 1;
+    fclose(f);
+    return ok;
+}
+
+// Carga la entrada cuya clave ya está en e (n, semillas, tipo). Devuelve 1 si
+// hay acierto: hashes compartidos y tiempo de este host y binario.
+static inline int ref_cache_load(ref_entry_t *e) {
+    char path[REF_CACHE_PATH_MAX], key[128], stored_key[128];
+    if (!ref_cache_path(e, NULL, path, sizeof(path))) return 0;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+
+    ref_cache_key(e, key, sizeof(key));
+    int ok = fscanf(f, "%127s", stored_key) == 1 && strcmp(key, stored_key) == 0
+          && fscanf(f, "%lld", &e->checksum) == 1;
+    for (int i = 0; ok && i < e->n; i++) {
+        unsigned long long h;
+        ok = fscanf(f, "%llx", &h) == 1;
+        e->row_hash[i] = (uint64_t)h;
+    }
+    fclose(f);
+    return ok && ref_cache_load_timing(e);
+}
+
+// Escribe path desde tmp (archivo temporal + rename para no dejar entradas a medias)
+static inline int ref_cache_commit(FILE *f, const char *tmp, const char *path) {
+    if (fclose(f) != 0) return 0;
+    return rename(tmp, path) == 0;
+}
+
+// Escribe los hashes y el tiempo de este host y binario
+static inline int ref_cache_store(const ref_entry_t *e) {
+    char path[REF_CACHE_PATH_MAX], tmp[REF_CACHE_PATH_MAX + 8], key[128], origin[REF_CACHE_ORIGIN_MAX];
+    const char *dir = ref_cache_dir();
+    if (!ref_cache_path(e, NULL, path, sizeof(path))) return 0;
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return 0;
+    ref_cache_key(e, key, sizeof(key));
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "w");
+    if (f == NULL) return 0;
+    fprintf(f, "%s\n%lld\n", key, e->checksum);
+    for (int i = 0; i < e->n; i++) {
+        fprintf(f, "%016llx\n", (unsigned long long)e->row_hash[i]);
+    }
+    if (!ref_cache_commit(f, tmp, path)) return 0;
+
+    ref_cache_origin(origin, sizeof(origin));
+    ref_cache_path(e, origin, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    f = fopen(tmp, "w");
+    if (f == NULL) return 0;
+    fprintf(f, "%s\n%s\n%.9f\n", key, origin, e->seq_wall);
+    return ref_cache_commit(f, tmp, path);
+}
+
+// Verifica una fila de C contra la referencia; devuelve 1 si coincide
+static inline int ref_check_row_int(const ref_entry_t *e, int i, const int *row) {
+    return e->row_hash[i] == ref_row_hash_int(row, e->n);
+}
+
+static inline int ref_check_row_double(const ref_entry_t *e, int i, const double *row) {
+    return e->row_hash[i] == ref_row_hash_double(row, e->n);
+}
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * row_partition.h - Reparto de filas proporcional a la velocidad de cada rango
+ *
+ * Con nodos de distinto tipo en el hostfile, repartir n/P filas a cada rango
+ * hace que el más lento marque el tiempo total. rp_plan calcula cuántas filas
+ * recibe cada rango según un peso:
+ *   - "equal" (o NULL): todos pesan 1; reparte cualquier n, las sobras de uno
+ *     en uno
+ *   - "calibrate": cada rango mide durante ~RP_CAL_SECONDS los FLOP/s de un
+ *     producto RP_CAL_N x RP_CAL_N con el mismo bucle ijk de los programas, y
+ *     los pesos se comparten con MPI_Allgather
+ *   - cualquier otro texto: ruta de un archivo de pesos, un número positivo
+ *     por línea en orden de rango (las líneas que empiezan con '#' se ignoran);
+ *     lo lee el rango 0 y lo difunde
+ * Las filas se asignan por restos mayores, así que suman exactamente n. El
+ * plan trae los counts/displs en elementos (filas x n) listos para
+ * MPI_Scatterv y MPI_Gatherv.
+ *
+ * Requiere MPI: solo lo usa HPCCasoEstudio3.
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef ROW_PARTITION_H
+#define ROW_PARTITION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#define RP_CAL_N 128
+#define RP_CAL_SECONDS 0.05
+#define RP_LINE_MAX 256
+
+typedef struct {
+    const char *mode;            // "equal", "calibrate" o la ruta del archivo
+    int num_procs;
+    double *weights;             // Peso de cada rango (normalizado a suma 1)
+    int *rows;                   // Filas de cada rango
+    int *first_row;              // Primera fila global de cada rango
+    int *counts;                 // rows * n, para Scatterv/Gatherv
+    int *displs;                 // first_row * n
+} rp_plan_t;
+
+// FLOP/s de este rango con el kernel ijk de los programas
+static inline double rp_measure_speed(void) {
+    int n = RP_CAL_N;
+    double *a = (double*)malloc((size_t)n * n * sizeof(double));
+    double *b = (double*)malloc((size_t)n * n * sizeof(double));
+    double *c = (double*)malloc((size_t)n * n * sizeof(double));
+    if (a == NULL || b == NULL || c == NULL) {
+        free(a);
+        free(b);
+        free(c);
+        return 1.0;
+    }
+    for (int i = 0; i < n * n; i++) {
+        a[i] = (double)(i % 100);
+        b[i] = (double)((i * 7) % 100);
+    }
+
+    int reps = 0;
+    double start = MPI_Wtime(), elapsed;
+    do {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                double sum = 0.0;
+                for (int k = 0; k < n; k++) {
+                    sum += a[i * n + k] * b[k * n + j];
+                }
+                c[i * n + j] = sum;
+            }
+        }
+        reps++;
+        elapsed = MPI_Wtime() - start;
+    } while (elapsed < RP_CAL_SECONDS);
+
+    // Keeps the compiler from discarding the kernel
+    volatile double sink = c[(reps * 31) % (n * n)];
+    (void)sink;
+    free(a);
+    free(b);
+    free(c);
+    return 2.0 * n * n * n * reps / elapsed;
+}
+
+// Lee num_procs pesos positivos de path; 0 si falta alguno o hay uno inválido
+static inline int rp_read_weights(const char *path, int num_procs, double *weights) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return 0;
+    }
+    char line[RP_LINE_MAX];
+    int count = 0;
+    while (count < num_procs && fgets(line, sizeof(line), f) != NULL) {
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+        char *end;
+        double w = strtod(p, &end);
+        if (end == p || w <= 0.0) {
+            fprintf(stderr, "%s: invalid weight '%s'\n", path, p);
+            fclose(f);
+            return 0;
+        }
+        weights[count++] = w;
+    }
+    fclose(f);
+    if (count < num_procs) {
+        fprintf(stderr, "%s: %d weights for %d processes\n", path, count, num_procs);
+        return 0;
+    }
+    return 1;
+}
+
+// Filas por restos mayores: rows[r] = floor(n * w_r), y las sobras a los
+// mayores restos (a igualdad, al rango menor)
+static inline void rp_apportion(int n, int num_procs, const double *weights, int *rows) {
+    double total = 0.0;
+    for (int r = 0; r < num_procs; r++) total += weights[r];
+    int assigned = 0;
+    double *remainder = (double*)malloc(num_procs * sizeof(double));
+    for (int r = 0; r < num_procs; r++) {
+        double share = n * weights[r] / total;
+        rows[r] = (int)share;
+        remainder[r] = share - rows[r];
+        assigned += rows[r];
+    }
+    while (assigned < n) {
+        int best = 0;
+        for (int r = 1; r < num_procs; r++) {
+            if (remainder[r] > remainder[best]) best = r;
+        }
+        rows[best]++;
+        remainder[best] = -1.0;
+        assigned++;
+    }
+    free(remainder);
+}
+
+static inline void rp_free(rp_plan_t *plan) {
+    free(plan->weights);
+    free(plan->rows);
+    free(plan->first_row);
+    free(plan->counts);
+    free(plan->displs);
+    memset(plan, 0, sizeof(*plan));
+}
+
+// Colectivo: todos los rangos de comm deben llamarlo con el mismo n y mode.
+// 0 si el archivo de pesos no sirve (el plan queda vacío).
+static inline int rp_plan(rp_plan_t *plan, int n, const char *mode, MPI_Comm comm) {
+    int rank, num_procs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &num_procs);
+    memset(plan, 0, sizeof(*plan));
+    plan->mode = (mode != NULL) ? mode : "equal";
+    plan->num_procs = num_procs;
+    plan->weights = (double*)malloc(num_procs * sizeof(double));
+    plan->rows = (int*)malloc(num_procs * sizeof(int));
+    plan->first_row = (int*)malloc(num_procs * sizeof(int));
+    plan->counts = (int*)malloc(num_procs * sizeof(int));
+    plan->displs = (int*)malloc(num_procs * sizeof(int));
+
+    int ok = 1;
+    if (strcmp(plan->mode, "equal") == 0) {
+        for (int r = 0; r < num_procs; r++) plan->weights[r] = 1.0;
+    } else if (strcmp(plan->mode, "calibrate") == 0) {
+        double speed = rp_measure_speed();
+        MPI_Allgather(&speed, 1, MPI_DOUBLE, plan->weights, 1, MPI_DOUBLE, comm);
+    } else {
+        if (rank == 0) ok = rp_read_weights(plan->mode, num_procs, plan->weights);
+        MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+        if (ok) MPI_Bcast(plan->weights, num_procs, MPI_DOUBLE, 0, comm);
+    }
+    if (!ok) {
+        rp_free(plan);
+        return 0;
+    }
+
+    double total = 0.0;
+    for (int r = 0; r < num_procs; r++) total += plan->weights[r];
+    for (int r = 0; r < num_procs; r++) plan->weights[r] /= total;
+    rp_apportion(n, num_procs, plan->weights, plan->rows);
+    int next = 0;
+    for (int r = 0; r < num_procs; r++) {
+        plan->first_row[r] = next;
+        plan->counts[r] = plan->rows[r] * n;
+        plan->displs[r] = next * n;
+        next += plan->rows[r];
+    }
+    return 1;
+}
+
+// Imprime el reparto (llamar desde un solo rango)
+static inline void rp_print(const rp_plan_t *plan) {
+    printf("Row partition: %s\n", plan->mode);
+    for (int r = 0; r < plan->num_procs; r++) {
+        printf("  Rank %d: %d rows (weight %.3f)\n", r, plan->rows[r], plan->weights[r]);
+    }
+}
+
+#endif
@@ -0,0 +1,334 @@
+/*
+ * thread_pool.h - Pool de hilos persistente con robo de trabajo
+ *
+ * Los hilos se crean una vez (tp_create o tp_global) y se reutilizan entre
+ * llamadas. tp_parallel_for parte un rango [inicio, fin) en trozos de `grain`,
+ * reparte los trozos contiguos entre las colas de cada trabajador (igual que el
+ * reparto estático por filas de los programas) y espera a que terminen.
+ * Cada trabajador consume su cola por el fondo (LIFO) y, cuando se vacía,
+ * roba del frente (FIFO) de la cola de otro, así que un hilo retrasado no
+ * retiene al resto.
+ *
+ * Cada cola tiene su propio mutex: los trozos son de varias filas de una
+ * multiplicación, mucho más caros que tomar el lock.
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// Cuerpo de una tarea: procesa [begin, end) con los datos compartidos `arg`
+typedef void (*tp_task_fn)(void *arg, int begin, int end);
+
+// Se ejecuta una vez en cada trabajador al arrancar (p. ej. para fijar afinidad)
+typedef void (*tp_init_fn)(void *arg, int worker);
+
+typedef struct {
+    int begin;
+    int end;
+} tp_task_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    tp_task_t *items;
+    int head;                // Próximo a robar
+    int tail;                // Uno después del último propio
+    int cap;
+    long long executed;      // Tareas ejecutadas por este trabajador
+    long long stolen;        // De ellas, robadas a otra cola
+} tp_deque_t;
+
+typedef struct tp_pool tp_pool_t;
+
+typedef struct {
+    tp_pool_t *pool;
+    int id;
+} tp_worker_arg_t;
+
+struct tp_pool {
+    int num_workers;
+    pthread_t *threads;
+    tp_worker_arg_t *worker_args;
+    tp_deque_t *deques;
+
+    pthread_mutex_t lock;
+    pthread_cond_t work_cv;  // Trabajadores esperando una nueva ronda
+    pthread_cond_t done_cv;  // Llamador esperando el fin de la ronda
+    pthread_mutex_t submit;  // Una ronda a la vez
+    unsigned long generation;
+    int stop;
+    int pending;             // Tareas sin terminar de la ronda actual (atómico)
+
+    tp_task_fn fn;
+    void *arg;
+
+    tp_init_fn init;
+    void *init_arg;
+};
+
+// Toma la última tarea de la propia cola
+static inline int tp_pop(tp_deque_t *d, tp_task_t *out) {
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->tail > d->head) {
+        *out = d->items[--d->tail];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+// Roba la primera tarea de la cola de otro
+static inline int tp_steal(tp_deque_t *d, tp_task_t *out) {
+    int ok = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->tail > d->head) {
+        *out = d->items[d->head++];
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+static inline void* tp_worker_main(void *raw) {
+    tp_worker_arg_t *wa = (tp_worker_arg_t*)raw;
+    tp_pool_t *pool = wa->pool;
+    int self = wa->id;
+    tp_deque_t *own = &pool->deques[self];
+
+    if (pool->init != NULL) pool->init(pool->init_arg, self);
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        unsigned long gen = pool->generation;
+        int stop = pool->stop;
+        pthread_mutex_unlock(&pool->lock);
+        if (stop) break;
+
+        // Ejecuta hasta que no quede nada propio ni para robar
+        for (;;) {
+            tp_task_t task;
+            int stolen = 0;
+            if (!tp_pop(own, &task)) {
+                int found = 0;
+                for (int v = 1; v < pool->num_workers && !found; v++) {
+                    found = tp_steal(&pool->deques[(self + v) % pool->num_workers], &task);
+                }
+                if (!found) break;
+                stolen = 1;
+            }
+            pool->fn(pool->arg, task.begin, task.end);
+            own->executed++;
+            own->stolen += stolen;
+            if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+                pthread_mutex_lock(&pool->lock);
+                pthread_cond_signal(&pool->done_cv);
+                pthread_mutex_unlock(&pool->lock);
+            }
+        }
+
+        // Si se publicó una ronda después de leer `gen`, no se duerme
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->generation == gen) {
+            pthread_cond_wait(&pool->work_cv, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+// Crea el pool con num_workers hilos; init(init_arg, w), si no es NULL, corre
+// en cada trabajador antes de su primera tarea. NULL si falla.
+static inline tp_pool_t* tp_create_ex(int num_workers, tp_init_fn init, void *init_arg) {
+    tp_pool_t *pool = (tp_pool_t*)calloc(1, sizeof(tp_pool_t));
+    if (pool == NULL || num_workers <= 0) {
+        free(pool);
+        return NULL;
+    }
+    pool->num_workers = num_workers;
+    pool->init = init;
+    pool->init_arg = init_arg;
+    pool->threads = (pthread_t*)malloc(num_workers * sizeof(pthread_t));
+    pool->worker_args = (tp_worker_arg_t*)malloc(num_workers * sizeof(tp_worker_arg_t));
+    pool->deques = (tp_deque_t*)calloc(num_workers, sizeof(tp_deque_t));
+    if (pool->threads == NULL || pool->worker_args == NULL || pool->deques == NULL) {
+        free(pool->threads);
+        free(pool->worker_args);
+        free(pool->deques);
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_mutex_init(&pool->submit, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    for (int w = 0; w < num_workers; w++) {
+        pthread_mutex_init(&pool->deques[w].lock, NULL);
+    }
+    for (int w = 0; w < num_workers; w++) {
+        pool->worker_args[w].pool = pool;
+        pool->worker_args[w].id = w;
+        if (pthread_create(&pool->threads[w], NULL, tp_worker_main, &pool->worker_args[w]) != 0) {
+            // Detiene los ya creados
+            pthread_mutex_lock(&pool->lock);
+            pool->stop = 1;
+            pthread_cond_broadcast(&pool->work_cv);
+            pthread_mutex_unlock(&pool->lock);
+            for (int j = 0; j < w; j++) pthread_join(pool->threads[j], NULL);
+            for (int j = 0; j < num_workers; j++) free(pool->deques[j].items);
+            free(pool->threads);
+            free(pool->worker_args);
+            free(pool->deques);
+            free(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+// Crea el pool con num_workers hilos; NULL si falla
+static inline tp_pool_t* tp_create(int num_workers) {
+    return tp_create_ex(num_workers, NULL, NULL);
+}
+
+static inline void tp_destroy(tp_pool_t *pool) {
+    if (pool == NULL) return;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->lock);
+    for (int w = 0; w < pool->num_workers; w++) {
+        pthread_join(pool->threads[w], NULL);
+        pthread_mutex_destroy(&pool->deques[w].lock);
+        free(pool->deques[w].items);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->submit);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_cond_destroy(&pool->done_cv);
+    free(pool->threads);
+    free(pool->worker_args);
+    free(pool->deques);
+    free(pool);
+}
+
+// Ejecuta fn(arg, b, e) sobre [begin, end) en trozos de `grain` y espera a que
+// terminen todos. Devuelve 0 si no hubo memoria para las colas.
+static inline int tp_parallel_for(tp_pool_t *pool, int begin, int end, int grain, tp_task_fn fn, void *arg) {
+    if (end <= begin) return 1;
+    if (grain <= 0) grain = 1;
+    int chunks = (end - begin + grain - 1) / grain;
+
+    pthread_mutex_lock(&pool->submit);
+    // Las colas están vacías entre rondas: se agrandan antes de publicar nada
+    for (int w = 0; w < pool->num_workers; w++) {
+        tp_deque_t *d = &pool->deques[w];
+        int need = (int)((long long)(w + 1) * chunks / pool->num_workers) -
+                   (int)((long long)w * chunks / pool->num_workers);
+        pthread_mutex_lock(&d->lock);
+        if (d->cap < need) {
+            tp_task_t *items = (tp_task_t*)realloc(d->items, need * sizeof(tp_task_t));
+            if (items == NULL) {
+                pthread_mutex_unlock(&d->lock);
+                pthread_mutex_unlock(&pool->submit);
+                return 0;
+            }
+            d->items = items;
+            d->cap = need;
+        }
+        pthread_mutex_unlock(&d->lock);
+    }
+
+    // fn y pending se fijan antes de que haya tareas visibles: un trabajador que
+    // sigue buscando tareas de la ronda anterior puede tomar una nueva en cualquier momento
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->arg = arg;
+    __atomic_store_n(&pool->pending, chunks, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&pool->lock);
+
+    // Trozos contiguos por trabajador: el trabajador w recibe [w*chunks/W, (w+1)*chunks/W)
+    for (int w = 0; w < pool->num_workers; w++) {
+        tp_deque_t *d = &pool->deques[w];
+        int c0 = (int)((long long)w * chunks / pool->num_workers);
+        int c1 = (int)((long long)(w + 1) * chunks / pool->num_workers);
+        pthread_mutex_lock(&d->lock);
+        d->head = 0;
+        d->tail = 0;
+        for (int c = c0; c < c1; c++) {
+            int b = begin + c * grain;
+            d->items[d->tail].begin = b;
+            d->items[d->tail].end = (b + grain < end) ? b + grain : end;
+            d->tail++;
+        }
+        pthread_mutex_unlock(&d->lock);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_cv);
+    while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->submit);
+    return 1;
+}
+
+// Totales de tareas ejecutadas y robadas desde la creación del pool
+static inline void tp_stats(tp_pool_t *pool, long long *executed, long long *stolen) {
+    *executed = 0;
+    *stolen = 0;
+    for (int w = 0; w < pool->num_workers; w++) {
+        pthread_mutex_lock(&pool->deques[w].lock);
+        *executed += pool->deques[w].executed;
+        *stolen += pool->deques[w].stolen;
+        pthread_mutex_unlock(&pool->deques[w].lock);
+    }
+}
+
+static inline tp_pool_t** tp_global_slot(void) {
+    static tp_pool_t *global = NULL;
+    return &global;
+}
+
+// Pool compartido del programa: se crea en la primera llamada y se recrea solo si
+// cambia el número de hilos pedido. NULL si no se pudo crear.
+static inline tp_pool_t* tp_global(int num_workers) {
+    tp_pool_t **global = tp_global_slot();
+    if (*global != NULL && (*global)->num_workers != num_workers) {
+        tp_destroy(*global);
+        *global = NULL;
+    }
+    if (*global == NULL) *global = tp_create(num_workers);
+    return *global;
+}
+
+// Como tp_global, pero el pool se recrea también si cambia init/init_arg
+static inline tp_pool_t* tp_global_ex(int num_workers, tp_init_fn init, void *init_arg) {
+    tp_pool_t **global = tp_global_slot();
+    if (*global != NULL && ((*global)->num_workers != num_workers ||
+                            (*global)->init != init || (*global)->init_arg != init_arg)) {
+        tp_destroy(*global);
+        *global = NULL;
+    }
+    if (*global == NULL) *global = tp_create_ex(num_workers, init, init_arg);
+    return *global;
+}
+
+static inline void tp_global_destroy(void) {
+    tp_pool_t **global = tp_global_slot();
+    tp_destroy(*global);
+    *global = NULL;
+}
+
+// Trozo por defecto: unas 8 tareas por trabajador para que el robo pueda equilibrar
+static inline int tp_default_grain(int count, int num_workers) {
+    int grain = count / (num_workers * 8);
+    return grain > 0 ? grain : 1;
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * tile_scheduler.h - Reparto dinámico de teselas 2D de C
+ *
+ * C se divide en teselas de tile_rows x tile_cols numeradas fila a fila
+ * (teselas consecutivas comparten filas de A). Los trabajadores piden trozos
+ * de teselas a un contador atómico compartido; el tamaño del trozo es guiado:
+ * restantes / (2 * trabajadores), nunca menor que min_chunk. Al principio se
+ * reparten trozos grandes (poca contención) y al final trozos de una tesela,
+ * así que un trabajador lento o interrumpido no fija el tiempo de pared.
+ *
+ * El planificador no contiene punteros ni locks: sirve igual para hilos y para
+ * procesos hijos si se coloca en memoria mmap(MAP_SHARED) antes del fork().
+ * Reservar ts_bytes(trabajadores) bytes.
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef TILE_SCHEDULER_H
+#define TILE_SCHEDULER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define TS_DEFAULT_TILE 64
+
+// Contadores de un trabajador; ocupan una línea de caché para no compartirla
+typedef struct {
+    long long tiles;         // Teselas calculadas
+    long long chunks;        // Veces que pidió trabajo al contador
+    char pad[48];
+} ts_worker_stats_t;
+
+typedef struct {
+    int rows, cols;          // Dimensiones de C
+    int tile_rows, tile_cols;
+    int tiles_per_row;       // Teselas en una fila de teselas
+    int total_tiles;
+    int num_workers;
+    int min_chunk;
+    char pad[32];
+    int next;                // Próxima tesela sin asignar (atómico)
+    char pad_next[60];
+    ts_worker_stats_t workers[];
+} ts_sched_t;
+
+static inline size_t ts_bytes(int num_workers) {
+    return sizeof(ts_sched_t) + (size_t)num_workers * sizeof(ts_worker_stats_t);
+}
+
+// Prepara una nueva multiplicación; tile <= 0 usa TS_DEFAULT_TILE
+static inline void ts_init(ts_sched_t *s, int rows, int cols, int tile_rows, int tile_cols, int num_workers) {
+    s->rows = rows;
+    s->cols = cols;
+    s->tile_rows = tile_rows > 0 ? tile_rows : TS_DEFAULT_TILE;
+    s->tile_cols = tile_cols > 0 ? tile_cols : TS_DEFAULT_TILE;
+    s->tiles_per_row = (cols + s->tile_cols - 1) / s->tile_cols;
+    s->total_tiles = ((rows + s->tile_rows - 1) / s->tile_rows) * s->tiles_per_row;
+    s->num_workers = num_workers;
+    s->min_chunk = 1;
+    for (int w = 0; w < num_workers; w++) {
+        s->workers[w].tiles = 0;
+        s->workers[w].chunks = 0;
+    }
+    __atomic_store_n(&s->next, 0, __ATOMIC_RELEASE);
+}
+
+// Reserva el siguiente trozo para `worker`: teselas [*first, *first + *count).
+// Devuelve 0 cuando ya no quedan teselas.
+static inline int ts_next(ts_sched_t *s, int worker, int *first, int *count) {
+    int cur = __atomic_load_n(&s->next, __ATOMIC_RELAXED);
+    for (;;) {
+        int remaining = s->total_tiles - cur;
+        if (remaining <= 0) return 0;
+        int chunk = remaining / (2 * s->num_workers);
+        if (chunk < s->min_chunk) chunk = s->min_chunk;
+        if (chunk > remaining) chunk = remaining;
+        // Si otro trabajador avanzó el contador, cur se actualiza y se reintenta
+        if (__atomic_compare_exchange_n(&s->next, &cur, cur + chunk, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            *first = cur;
+            *count = chunk;
+            s->workers[worker].tiles += chunk;
+            s->workers[worker].chunks++;
+            return 1;
+        }
+    }
+}
+
+// Límites [i0, i1) x [j0, j1) de la tesela t
+static inline void ts_tile_bounds(const ts_sched_t *s, int t, int *i0, int *i1, int *j0, int *j1) {
+    *i0 = (t / s->tiles_per_row) * s->tile_rows;
+    *j0 = (t % s->tiles_per_row) * s->tile_cols;
+    *i1 = (*i0 + s->tile_rows < s->rows) ? *i0 + s->tile_rows : s->rows;
+    *j1 = (*j0 + s->tile_cols < s->cols) ? *j0 + s->tile_cols : s->cols;
+}
+
+// Teselas y trozos por trabajador (`label`: "Hilo", "Proceso", ...)
+static inline void ts_report(const ts_sched_t *s, const char *label) {
+    printf("Teselas de %dx%d: %d en total\n", s->tile_rows, s->tile_cols, s->total_tiles);
+    for (int w = 0; w < s->num_workers; w++) {
+        printf("  %s %d: %lld teselas en %lld trozos\n", label, w,
+               s->workers[w].tiles, s->workers[w].chunks);
+    }
+}
+
+#endif
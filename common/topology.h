@@ -0,0 +1,292 @@
+/*
+ * topology.h - Topología de CPUs leída de /sys y fijado de afinidad
+ *
+ * Lee los nodos NUMA de /sys/devices/system/node (nodeN/cpulist). Si el
+ * directorio no existe (kernel sin NUMA, contenedores), se considera un único
+ * nodo con todas las CPUs en línea.
+ *
+ * topo_load lee además, por CPU, paquete, núcleo físico, hermanos SMT y qué
+ * CPUs comparten la L2 y la L3 (cpuN/topology y cpuN/cache/indexK).
+ * topo_order da el orden de CPUs en que se fijan los trabajadores según la
+ * política:
+ *   compact: CPUs vecinas primero (hermanos SMT juntos, luego misma L2/L3)
+ *   scatter: un núcleo de cada grupo de L3 por turno, hermanos SMT al final
+ *   core:    un hilo por núcleo físico, sin hermanos SMT
+ * El trabajador w se fija a order[w % count].
+ *
+ * Requiere _GNU_SOURCE antes del primer #include (cpu_set_t, CPU_SET).
+ *
+ * Solo cabecera: las funciones son static inline para que cada ejecutable del
+ * repositorio siga compilándose desde un único .c.
+ */
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+
+#define TOPO_MAX_CPUS 1024
+#define TOPO_MAX_NODES 64
+#define TOPO_SYS_CPU "/sys/devices/system/cpu"
+#define TOPO_SYS_NODE "/sys/devices/system/node"
+
+enum { TOPO_NONE = 0, TOPO_COMPACT, TOPO_SCATTER, TOPO_CORE };
+
+typedef struct {
+    int cpu;
+    int node;
+    int package;
+    int core;                    // core_id dentro del paquete
+    int smt;                     // Posición entre sus hermanos SMT (0 = primero)
+    int l2;                      // Menor CPU que comparte la L2 (-1 si se desconoce)
+    int l3;                      // Menor CPU que comparte la L3 (-1 si se desconoce)
+} topo_cpu_t;
+
+typedef struct {
+    int num_cpus;
+    int num_cores;               // Núcleos físicos (CPUs con smt == 0)
+    int num_packages;
+    int num_nodes;
+    topo_cpu_t cpus[TOPO_MAX_CPUS];
+} topo_t;
+
+typedef struct {
+    int id;                      // Número de nodo en /sys
+    int num_cpus;
+    int cpus[TOPO_MAX_CPUS];
+} topo_node_t;
+
+// Interpreta una lista de CPUs del kernel ("0-3,8,10-11"); devuelve cuántas leyó
+static inline int topo_parse_cpulist(const char *s, int *cpus, int max) {
+    int count = 0;
+    while (*s != '\0' && *s != '\n') {
+        char *end;
+        long a = strtol(s, &end, 10);
+        if (end == s) break;
+        long b = a;
+        s = end;
+        if (*s == '-') {
+            b = strtol(s + 1, &end, 10);
+            s = end;
+        }
+        for (long c = a; c <= b && count < max; c++) cpus[count++] = (int)c;
+        if (*s == ',') s++;
+    }
+    return count;
+}
+
+// Lee una lista de CPUs de un archivo de /sys; 0 si no existe
+static inline int topo_read_cpulist(const char *path, int *cpus, int max) {
+    char buf[4096];
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return 0;
+    int ok = fgets(buf, sizeof(buf), f) != NULL;
+    fclose(f);
+    return ok ? topo_parse_cpulist(buf, cpus, max) : 0;
+}
+
+// CPUs en línea; si /sys no está disponible, 0..sysconf-1
+static inline int topo_online_cpus(int *cpus, int max) {
+    int count = topo_read_cpulist(TOPO_SYS_CPU "/online", cpus, max);
+    if (count > 0) return count;
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    for (count = 0; count < n && count < max; count++) cpus[count] = count;
+    return count > 0 ? count : 1;
+}
+
+// Nodos NUMA con al menos una CPU; siempre devuelve al menos uno
+static inline int topo_numa_nodes(topo_node_t *nodes, int max_nodes) {
+    int ids[TOPO_MAX_NODES];
+    int num_ids = topo_read_cpulist(TOPO_SYS_NODE "/online", ids, TOPO_MAX_NODES);
+    int count = 0;
+    for (int i = 0; i < num_ids && count < max_nodes; i++) {
+        char path[256];
+        snprintf(path, sizeof(path), TOPO_SYS_NODE "/node%d/cpulist", ids[i]);
+        nodes[count].id = ids[i];
+        nodes[count].num_cpus = topo_read_cpulist(path, nodes[count].cpus, TOPO_MAX_CPUS);
+        if (nodes[count].num_cpus > 0) count++;
+    }
+    if (count == 0) {
+        nodes[0].id = 0;
+        nodes[0].num_cpus = topo_online_cpus(nodes[0].cpus, TOPO_MAX_CPUS);
+        count = 1;
+    }
+    return count;
+}
+
+static inline int topo_read_int(const char *path, int fallback) {
+    int value;
+    FILE *f = fopen(path, "r");
+    if (f == NULL) return fallback;
+    if (fscanf(f, "%d", &value) != 1) value = fallback;
+    fclose(f);
+    return value;
+}
+
+// Menor CPU de la lista (identifica al grupo que comparte un recurso); -1 si no hay
+static inline int topo_read_group(const char *path) {
+    int cpus[TOPO_MAX_CPUS];
+    int count = topo_read_cpulist(path, cpus, TOPO_MAX_CPUS);
+    int min = -1;
+    for (int i = 0; i < count; i++) {
+        if (min < 0 || cpus[i] < min) min = cpus[i];
+    }
+    return min;
+}
+
+// Carga la topología de las CPUs en línea
+static inline void topo_load(topo_t *t) {
+    int online[TOPO_MAX_CPUS];
+    char path[256];
+    t->num_cpus = topo_online_cpus(online, TOPO_MAX_CPUS);
+    t->num_cores = 0;
+    for (int i = 0; i < t->num_cpus; i++) {
+        topo_cpu_t *c = &t->cpus[i];
+        c->cpu = online[i];
+        c->node = 0;
+        snprintf(path, sizeof(path), TOPO_SYS_CPU "/cpu%d/topology/physical_package_id", c->cpu);
+        c->package = topo_read_int(path, 0);
+        snprintf(path, sizeof(path), TOPO_SYS_CPU "/cpu%d/topology/core_id", c->cpu);
+        c->core = topo_read_int(path, c->cpu);
+
+        int siblings[TOPO_MAX_CPUS];
+        snprintf(path, sizeof(path), TOPO_SYS_CPU "/cpu%d/topology/thread_siblings_list", c->cpu);
+        int num_siblings = topo_read_cpulist(path, siblings, TOPO_MAX_CPUS);
+        c->smt = 0;
+        for (int s = 0; s < num_siblings; s++) {
+            if (siblings[s] < c->cpu) c->smt++;
+        }
+        if (c->smt == 0) t->num_cores++;
+
+        c->l2 = -1;
+        c->l3 = -1;
+        for (int idx = 0; idx < 8; idx++) {
+            snprintf(path, sizeof(path), TOPO_SYS_CPU "/cpu%d/cache/index%d/level", c->cpu, idx);
+            int level = topo_read_int(path, -1);
+            if (level < 0) break;
+            snprintf(path, sizeof(path), TOPO_SYS_CPU "/cpu%d/cache/index%d/shared_cpu_list", c->cpu, idx);
+            if (level == 2) c->l2 = topo_read_group(path);
+            if (level == 3) c->l3 = topo_read_group(path);
+        }
+        if (c->l2 < 0) c->l2 = c->cpu;
+        if (c->l3 < 0) c->l3 = c->package;
+    }
+
+    topo_node_t *nodes = (topo_node_t*)malloc(TOPO_MAX_NODES * sizeof(topo_node_t));
+    t->num_nodes = 1;
+    if (nodes != NULL) {
+        t->num_nodes = topo_numa_nodes(nodes, TOPO_MAX_NODES);
+        for (int d = 0; d < t->num_nodes; d++) {
+            for (int k = 0; k < nodes[d].num_cpus; k++) {
+                for (int i = 0; i < t->num_cpus; i++) {
+                    if (t->cpus[i].cpu == nodes[d].cpus[k]) t->cpus[i].node = nodes[d].id;
+                }
+            }
+        }
+        free(nodes);
+    }
+
+    t->num_packages = 0;
+    for (int i = 0; i < t->num_cpus; i++) {
+        int seen = 0;
+        for (int j = 0; j < i && !seen; j++) seen = t->cpus[j].package == t->cpus[i].package;
+        if (!seen) t->num_packages++;
+    }
+}
+
+// Clave de orden compacto: nodo, L3, L2, núcleo, hermano SMT
+static inline int topo_compact_cmp(const topo_cpu_t *a, const topo_cpu_t *b) {
+    if (a->node != b->node) return a->node - b->node;
+    if (a->package != b->package) return a->package - b->package;
+    if (a->l3 != b->l3) return a->l3 - b->l3;
+    if (a->l2 != b->l2) return a->l2 - b->l2;
+    if (a->core != b->core) return a->core - b->core;
+    return a->cpu - b->cpu;
+}
+
+// Orden de CPUs para la política; devuelve cuántas hay (0 para TOPO_NONE)
+static inline int topo_order(const topo_t *t, int policy, int *order, int max) {
+    if (policy == TOPO_NONE) return 0;
+    int count = 0;
+    int *rank = (int*)malloc(t->num_cpus * sizeof(int));
+    topo_cpu_t *sorted = (topo_cpu_t*)malloc(t->num_cpus * sizeof(topo_cpu_t));
+    if (rank == NULL || sorted == NULL) {
+        free(rank);
+        free(sorted);
+        return 0;
+    }
+
+    // Inserción: hay pocas CPUs y así el orden no depende de qsort
+    for (int i = 0; i < t->num_cpus; i++) {
+        int j = i;
+        while (j > 0 && topo_compact_cmp(&sorted[j - 1], &t->cpus[i]) > 0) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = t->cpus[i];
+    }
+
+    if (policy == TOPO_COMPACT) {
+        // Hermanos SMT juntos: dentro de cada núcleo ya quedan contiguos
+        for (int i = 0; i < t->num_cpus && count < max; i++) order[count++] = sorted[i].cpu;
+    } else if (policy == TOPO_CORE) {
+        for (int i = 0; i < t->num_cpus && count < max; i++) {
+            if (sorted[i].smt == 0) order[count++] = sorted[i].cpu;
+        }
+    } else {
+        // scatter: rango de cada CPU dentro de su grupo de L3 (por nivel SMT) y
+        // luego se recorre rango a rango pasando por todos los grupos
+        int max_rank = 0, max_smt = 0;
+        for (int i = 0; i < t->num_cpus; i++) {
+            rank[i] = 0;
+            for (int j = 0; j < i; j++) {
+                if (sorted[j].node == sorted[i].node && sorted[j].l3 == sorted[i].l3 &&
+                    sorted[j].smt == sorted[i].smt) rank[i]++;
+            }
+            if (rank[i] > max_rank) max_rank = rank[i];
+            if (sorted[i].smt > max_smt) max_smt = sorted[i].smt;
+        }
+        for (int s = 0; s <= max_smt; s++) {
+            for (int r = 0; r <= max_rank; r++) {
+                for (int i = 0; i < t->num_cpus && count < max; i++) {
+                    if (sorted[i].smt == s && rank[i] == r) order[count++] = sorted[i].cpu;
+                }
+            }
+        }
+    }
+    free(rank);
+    free(sorted);
+    return count;
+}
+
+static inline int topo_policy_parse(const char *s) {
+    if (strcmp(s, "none") == 0) return TOPO_NONE;
+    if (strcmp(s, "compact") == 0) return TOPO_COMPACT;
+    if (strcmp(s, "scatter") == 0) return TOPO_SCATTER;
+    if (strcmp(s, "core") == 0) return TOPO_CORE;
+    return -1;
+}
+
+static inline const char* topo_policy_name(int policy) {
+    switch (policy) {
+        case TOPO_COMPACT: return "compact";
+        case TOPO_SCATTER: return "scatter";
+        case TOPO_CORE: return "core";
+        default: return "none";
+    }
+}
+
+// Fija el hilo que llama a las CPUs indicadas; 0 si el kernel lo rechazó
+static inline int topo_pin_self(const int *cpus, int count) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE) CPU_SET(cpus[i], &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+#endif